@@ -0,0 +1,669 @@
+/**
+ * physicslfo_bench - Native benchmark for the physicslfo~ DSP core
+ *
+ * Times every physics type through the render paths of the external, without
+ * Max:
+ *   scalar     - per-sample simulate_* (signal-rate physics/damping)
+ *   closed     - vectorized block kernels (float controls, @engine closed)
+ *   recursive  - phasor/decay recurrences (float controls, @engine recursive)
+ *   single     - float32 block kernels (float controls, @precision single)
+ *
+ * Each row covers one type, path, block size and sample rate, averaged over a
+ * sweep of physics and damping values. Reports ns/sample and, where hardware
+ * counters are available (Linux perf events), instructions/sample.
+ *
+ * Golden-output regression: --write-golden renders a fixed-seed parameter sweep
+ * through the scalar simulate_* reference into a golden file; --compare renders
+ * the same sweep through every engine (plus wavetable playback) and checks it
+ * against the golden file, or against a live reference render when no file is
+ * given. It prints max-abs error, the peak of the error spectrum relative to
+ * the reference spectrum, and speed relative to the reference, and exits with
+ * status 1 if any engine is outside its tolerance.
+ *
+ * Usage: physicslfo_bench [--seconds <s>] [--freq <hz>] [--quick]
+ *        physicslfo_bench --write-golden <file>
+ *        physicslfo_bench --compare [<file>]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "physicslfo_core.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define BENCH_MAX_BLOCK 1024
+
+// Golden sweep: points per type, length of each render, block size, sample rate
+#define BENCH_GOLDEN_MAGIC "PLFOGLD2"
+#define BENCH_GOLDEN_POINTS 6
+#define BENCH_GOLDEN_SAMPLES 4096       // Power of two, also the FFT size
+#define BENCH_GOLDEN_BLOCK 64
+#define BENCH_GOLDEN_SR 44100.0
+#define BENCH_GOLDEN_SEED 0x5EEDu
+#define BENCH_GOLDEN_PARAM_TOLERANCE 1e-9 // Stored sweep parameters vs this build's (libm pow drift)
+#define BENCH_GOLDEN_REPEATS 3          // Timing passes over the sweep per engine
+
+// Wavetable playback, matching the external's @tablesize default
+#define BENCH_TABLE_SIZE 1024
+#define BENCH_TABLE_OVERSAMPLE 4
+
+enum { BENCH_SCALAR, BENCH_CLOSED, BENCH_RECURSIVE, BENCH_SINGLE, BENCH_ENGINES, BENCH_TABLE = BENCH_ENGINES };
+
+static const char *bench_engine_names[BENCH_ENGINES] = { "scalar", "closed", "recursive", "single" };
+static const int bench_engine_flags[BENCH_ENGINES] = { 0, 0, PHYSICS_RENDER_RECURSIVE, PHYSICS_RENDER_SINGLE };
+static const long bench_blocks[] = { 16, 64, 256, 1024 };
+static const double bench_rates[] = { 44100.0, 48000.0, 96000.0 };
+static const double bench_params[] = { 0.0, 0.25, 0.5, 0.75, 1.0 };
+static const double bench_dampings[] = { 0.1, 0.5, 0.9 };
+
+#define BENCH_COUNT(a) ((long)(sizeof(a) / sizeof((a)[0])))
+
+//----------------------------------------------------------------------------------------------
+// Timing and Counters
+//----------------------------------------------------------------------------------------------
+
+static double bench_now_ns(void) {
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    
+    if (!frequency.QuadPart) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1e9 / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+#endif
+}
+
+// Retired user-space instructions of this thread, or -1 when unavailable
+static int bench_counter = -1;
+
+static void bench_counter_open(void) {
+#if defined(__linux__)
+    struct perf_event_attr attr;
+    
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    bench_counter = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+}
+
+static void bench_counter_start(void) {
+#if defined(__linux__)
+    if (bench_counter >= 0) {
+        ioctl(bench_counter, PERF_EVENT_IOC_RESET, 0);
+        ioctl(bench_counter, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+static double bench_counter_stop(void) {
+#if defined(__linux__)
+    long long count = 0;
+    
+    if (bench_counter >= 0) {
+        ioctl(bench_counter, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(bench_counter, &count, sizeof(count)) == sizeof(count)) {
+            return (double)count;
+        }
+    }
+#endif
+    return -1.0;
+}
+
+//----------------------------------------------------------------------------------------------
+// Render Paths
+//----------------------------------------------------------------------------------------------
+
+// Per-sample path of the external (physics or damping arriving as signals)
+static void bench_render_scalar(t_physics_voice *v, long type, double *out, long n, double param, double damping,
+                                double inc, long looping) {
+    double phase = v->phase;
+    long i;
+    
+    for (i = 0; i < n; i++) {
+        if (physicslfo_advance_phase(v, looping, &phase, inc, 0.0))
+            reset_physics_state(v);
+        physics_coefs_update(&v->coefs, param, damping);
+        
+        switch (type) {
+            case 0:  out[i] = simulate_bounce(v, phase, &v->coefs); break;
+            case 1:  out[i] = simulate_elastic(v, phase, &v->coefs); break;
+            case 2:  out[i] = simulate_bounce_spin(v, phase, &v->coefs); break;
+            case 3:  out[i] = simulate_elastic_overshoot(v, phase, &v->coefs); break;
+            case 4:  out[i] = simulate_multibounce(v, phase, &v->coefs); break;
+            case 5:  out[i] = simulate_wobble(v, phase, &v->coefs); break;
+        }
+    }
+    v->phase = phase;
+}
+
+static void bench_voice_init(t_physics_voice *v, double param, double damping) {
+    memset(v, 0, sizeof(*v));
+    reset_physics_state(v);
+    physics_coefs_build(&v->coefs, param, damping);
+}
+
+// Render samples of audio block by block; returns elapsed ns and stores the
+// instruction count (or -1) in instructions
+static double bench_run(long engine, long type, long block, double sr, double freq, long samples,
+                        double param, double damping, double *instructions, double *checksum) {
+    static double out[BENCH_MAX_BLOCK];
+    t_physics_voice voice;
+    double inc = freq / sr;
+    double start;
+    long done;
+    
+    bench_voice_init(&voice, param, damping);
+    
+    bench_counter_start();
+    start = bench_now_ns();
+    for (done = 0; done < samples; done += block) {
+        if (engine == BENCH_SCALAR) {
+            bench_render_scalar(&voice, type, out, block, param, damping, inc, 1);
+        } else {
+            physics_voice_render(&voice, type, out, block, param, damping, inc, 1, bench_engine_flags[engine]);
+        }
+        *checksum += out[block - 1];
+    }
+    start = bench_now_ns() - start;
+    *instructions = bench_counter_stop();
+    
+    return start;
+}
+
+//----------------------------------------------------------------------------------------------
+// Golden Reference
+//----------------------------------------------------------------------------------------------
+
+typedef struct _bench_point {
+    long type;
+    long looping;               // 0 = one envelope from phase 0
+    double param;
+    double damping;
+    double freq;
+} t_bench_point;
+
+typedef struct _bench_golden {
+    long count;
+    t_bench_point points[6 * BENCH_GOLDEN_POINTS];
+    double *data;               // count * BENCH_GOLDEN_SAMPLES reference samples
+    double *tables;             // count * (BENCH_TABLE_SIZE + 1), wavetable of each looping point
+} t_bench_golden;
+
+static const char *bench_golden_engines[] = { "scalar", "closed", "recursive", "single", "table" };
+static const double bench_golden_tolerance[] = { 1e-12, 1e-9, 1e-9, 1e-5, 0.05 };
+
+// Fixed-seed LCG so every build sweeps the same points
+static double bench_random(unsigned long *state) {
+    *state = (*state * 1103515245ul + 12345ul) & 0x7ffffffful;
+    return (double)*state / 2147483648.0;
+}
+
+// Per type: both parameter corners, a random spread, and one envelope
+static void bench_golden_points(t_bench_golden *golden) {
+    unsigned long state = BENCH_GOLDEN_SEED;
+    long type, k;
+    
+    golden->count = 0;
+    for (type = 0; type < 6; type++) {
+        for (k = 0; k < BENCH_GOLDEN_POINTS; k++) {
+            t_bench_point *pt = golden->points + golden->count++;
+            
+            pt->type = type;
+            pt->looping = k < BENCH_GOLDEN_POINTS - 1;
+            pt->param = k == 0 ? 0.0 : k == 1 ? 1.0 : bench_random(&state);
+            pt->damping = k == 0 ? 0.0 : k == 1 ? 1.0 : bench_random(&state);
+            pt->freq = 0.5 * pow(100.0, bench_random(&state));     // 0.5 to 50 Hz, log spread
+        }
+    }
+}
+
+// Wavetable playback through physics_table_read, the lookup of the external's table path
+static void bench_render_table(t_physics_voice *v, const double *table, double *out, long n, double inc) {
+    double phase = v->phase;
+    long i;
+    
+    for (i = 0; i < n; i++) {
+        if (physicslfo_advance_phase(v, 1, &phase, inc, 0.0))
+            reset_physics_state(v);
+        out[i] = physics_table_read(table, BENCH_TABLE_SIZE, phase);
+    }
+    v->phase = phase;
+}
+
+// Render one sweep point block by block. Envelope points start as a bang in
+// envelope mode would; table mode plays those through the block kernels, as
+// the external does. Tables are rendered up front (the external renders them
+// on the message thread), so only playback is timed.
+static void bench_render_point(long engine, const t_bench_point *pt, const double *table, double *out) {
+    t_physics_voice voice;
+    double inc = pt->freq / BENCH_GOLDEN_SR;
+    long done;
+    
+    bench_voice_init(&voice, pt->param, pt->damping);
+    voice.envelope_active = !pt->looping;
+    
+    for (done = 0; done < BENCH_GOLDEN_SAMPLES; done += BENCH_GOLDEN_BLOCK) {
+        double *block = out + done;
+        
+        if (engine == BENCH_SCALAR) {
+            bench_render_scalar(&voice, pt->type, block, BENCH_GOLDEN_BLOCK, pt->param, pt->damping, inc,
+                                pt->looping);
+        } else if (engine == BENCH_TABLE && pt->looping) {
+            bench_render_table(&voice, table, block, BENCH_GOLDEN_BLOCK, inc);
+        } else {
+            physics_voice_render(&voice, pt->type, block, BENCH_GOLDEN_BLOCK, pt->param, pt->damping, inc,
+                                 pt->looping, bench_engine_flags[engine]);
+        }
+    }
+}
+
+static int bench_golden_alloc(t_bench_golden *golden) {
+    long k;
+    
+    golden->data = (double *)malloc(sizeof(double) * golden->count * BENCH_GOLDEN_SAMPLES);
+    golden->tables = (double *)malloc(sizeof(double) * golden->count * (BENCH_TABLE_SIZE + 1));
+    if (!golden->data || !golden->tables) return 0;
+    
+    for (k = 0; k < golden->count; k++) {
+        const t_bench_point *pt = golden->points + k;
+        
+        if (pt->looping) {
+            physics_cycle_render(pt->type, pt->param, pt->damping, golden->tables + k * (BENCH_TABLE_SIZE + 1),
+                                 BENCH_TABLE_SIZE, BENCH_TABLE_OVERSAMPLE);
+        }
+    }
+    return 1;
+}
+
+static void bench_golden_free(t_bench_golden *golden) {
+    free(golden->data);
+    free(golden->tables);
+}
+
+static void bench_golden_reference(t_bench_golden *golden) {
+    long k;
+    
+    for (k = 0; k < golden->count; k++) {
+        bench_render_point(BENCH_SCALAR, golden->points + k, NULL, golden->data + k * BENCH_GOLDEN_SAMPLES);
+    }
+}
+
+// Little-endian fields, so a golden file made on one platform reads on another
+static int bench_write_u32(FILE *f, uint32_t value) {
+    unsigned char bytes[4];
+    int i;
+    
+    for (i = 0; i < 4; i++) bytes[i] = (unsigned char)(value >> (8 * i));
+    return fwrite(bytes, 4, 1, f) == 1;
+}
+
+static int bench_write_f64(FILE *f, double value) {
+    unsigned char bytes[8];
+    uint64_t bits;
+    int i;
+    
+    memcpy(&bits, &value, 8);
+    for (i = 0; i < 8; i++) bytes[i] = (unsigned char)(bits >> (8 * i));
+    return fwrite(bytes, 8, 1, f) == 1;
+}
+
+static int bench_read_u32(FILE *f, uint32_t *value) {
+    unsigned char bytes[4];
+    int i;
+    
+    if (fread(bytes, 4, 1, f) != 1) return 0;
+    *value = 0;
+    for (i = 0; i < 4; i++) *value |= (uint32_t)bytes[i] << (8 * i);
+    return 1;
+}
+
+static int bench_read_f64(FILE *f, double *value) {
+    unsigned char bytes[8];
+    uint64_t bits = 0;
+    int i;
+    
+    if (fread(bytes, 8, 1, f) != 1) return 0;
+    for (i = 0; i < 8; i++) bits |= (uint64_t)bytes[i] << (8 * i);
+    memcpy(value, &bits, 8);
+    return 1;
+}
+
+// The stored parameters may differ from this build's by the last bits of pow()
+static int bench_param_matches(double stored, double value) {
+    return fabs(stored - value) <= BENCH_GOLDEN_PARAM_TOLERANCE * fmax(1.0, fabs(value));
+}
+
+// File layout, all little-endian: magic, uint32 seed, point count and samples
+// per point, then per point uint32 type and looping, double param, damping and
+// freq, and the reference samples. The samples stay doubles: the reference and
+// the double-precision engines are held to 1e-12 and 1e-9, below what float32
+// or a quantized reference could carry (about 1.2 MB for the sweep).
+static int bench_golden_write(const t_bench_golden *golden, const char *path) {
+    FILE *f = fopen(path, "wb");
+    long k, i;
+    int ok;
+    
+    if (!f) return 0;
+    ok = fwrite(BENCH_GOLDEN_MAGIC, 8, 1, f) == 1 && bench_write_u32(f, BENCH_GOLDEN_SEED) &&
+         bench_write_u32(f, (uint32_t)golden->count) && bench_write_u32(f, BENCH_GOLDEN_SAMPLES);
+    for (k = 0; ok && k < golden->count; k++) {
+        const t_bench_point *pt = golden->points + k;
+        const double *data = golden->data + k * BENCH_GOLDEN_SAMPLES;
+        
+        ok = bench_write_u32(f, (uint32_t)pt->type) && bench_write_u32(f, (uint32_t)pt->looping) &&
+             bench_write_f64(f, pt->param) && bench_write_f64(f, pt->damping) && bench_write_f64(f, pt->freq);
+        for (i = 0; ok && i < BENCH_GOLDEN_SAMPLES; i++) {
+            ok = bench_write_f64(f, data[i]);
+        }
+    }
+    return fclose(f) == 0 && ok;
+}
+
+// Reads a golden file written by the same sweep definition: the seed, point
+// count and length must match exactly, each point's type and mode too, and
+// its parameters within BENCH_GOLDEN_PARAM_TOLERANCE. Any other sweep is
+// rejected rather than compared.
+static int bench_golden_read(t_bench_golden *golden, const char *path) {
+    FILE *f = fopen(path, "rb");
+    char magic[8];
+    uint32_t seed, count, samples;
+    long k, i;
+    int ok;
+    
+    if (!f) return 0;
+    ok = fread(magic, 8, 1, f) == 1 && !memcmp(magic, BENCH_GOLDEN_MAGIC, 8) &&
+         bench_read_u32(f, &seed) && bench_read_u32(f, &count) && bench_read_u32(f, &samples) &&
+         seed == BENCH_GOLDEN_SEED && count == (uint32_t)golden->count && samples == BENCH_GOLDEN_SAMPLES;
+    for (k = 0; ok && k < golden->count; k++) {
+        const t_bench_point *pt = golden->points + k;
+        double *data = golden->data + k * BENCH_GOLDEN_SAMPLES;
+        uint32_t type, looping;
+        double param, damping, freq;
+        
+        ok = bench_read_u32(f, &type) && bench_read_u32(f, &looping) && bench_read_f64(f, &param) &&
+             bench_read_f64(f, &damping) && bench_read_f64(f, &freq) &&
+             type == (uint32_t)pt->type && looping == (uint32_t)pt->looping &&
+             bench_param_matches(param, pt->param) && bench_param_matches(damping, pt->damping) &&
+             bench_param_matches(freq, pt->freq);
+        for (i = 0; ok && i < BENCH_GOLDEN_SAMPLES; i++) {
+            ok = bench_read_f64(f, data + i);
+        }
+    }
+    fclose(f);
+    return ok;
+}
+
+//----------------------------------------------------------------------------------------------
+// Comparison Metrics
+//----------------------------------------------------------------------------------------------
+
+// In-place radix-2 FFT, n a power of two
+static void bench_fft(double *re, double *im, long n) {
+    long i, j, len;
+    
+    for (i = 1, j = 0; i < n; i++) {
+        long bit = n >> 1;
+        
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            double t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+    for (len = 2; len <= n; len <<= 1) {
+        double angle = -2.0 * PI / len;
+        
+        for (i = 0; i < n; i += len) {
+            for (j = 0; j < len / 2; j++) {
+                double wr = cos(angle * j), wi = sin(angle * j);
+                double *ar = re + i + j, *ai = im + i + j;
+                double *br = re + i + j + len / 2, *bi = im + i + j + len / 2;
+                double tr = *br * wr - *bi * wi, ti = *br * wi + *bi * wr;
+                
+                *br = *ar - tr; *bi = *ai - ti;
+                *ar += tr; *ai += ti;
+            }
+        }
+    }
+}
+
+// Largest Hann-windowed magnitude bin of signal (up to Nyquist)
+static double bench_spectrum_peak(const double *signal, long n) {
+    static double re[BENCH_GOLDEN_SAMPLES], im[BENCH_GOLDEN_SAMPLES];
+    double peak = 0.0;
+    long i;
+    
+    for (i = 0; i < n; i++) {
+        re[i] = signal[i] * (0.5 - 0.5 * cos(2.0 * PI * i / n));
+        im[i] = 0.0;
+    }
+    bench_fft(re, im, n);
+    for (i = 0; i <= n / 2; i++) {
+        double magnitude = sqrt(re[i] * re[i] + im[i] * im[i]);
+        
+        if (magnitude > peak) peak = magnitude;
+    }
+    return peak;
+}
+
+// Compare every engine against the golden data. Returns the number of engines
+// outside their tolerance.
+static int bench_compare(const t_bench_golden *golden) {
+    static double out[BENCH_GOLDEN_SAMPLES], diff[BENCH_GOLDEN_SAMPLES];
+    double reference_ns = 0.0;
+    int failures = 0;
+    long engine, k, i, pass;
+    
+    printf("%-10s %12s %9s %14s %13s %11s  %s\n", "engine", "ns/sample", "speedup", "max-abs-err",
+           "spectral dBc", "tolerance", "result");
+    
+    for (engine = 0; engine <= BENCH_TABLE; engine++) {
+        double max_error = 0.0;
+        double spectral = 0.0;      // Worst error-spectrum peak / reference-spectrum peak
+        double start, ns;
+        long worst = 0;
+        
+        // Accuracy
+        for (k = 0; k < golden->count; k++) {
+            const double *reference = golden->data + k * BENCH_GOLDEN_SAMPLES;
+            double point_error = 0.0;
+            double ratio;
+            
+            bench_render_point(engine, golden->points + k, golden->tables + k * (BENCH_TABLE_SIZE + 1), out);
+            for (i = 0; i < BENCH_GOLDEN_SAMPLES; i++) {
+                diff[i] = out[i] - reference[i];
+                if (fabs(diff[i]) > point_error) point_error = fabs(diff[i]);
+            }
+            if (point_error > max_error) {
+                max_error = point_error;
+                worst = k;
+            }
+            if (point_error > 0.0) {
+                ratio = bench_spectrum_peak(diff, BENCH_GOLDEN_SAMPLES) /
+                        bench_spectrum_peak(reference, BENCH_GOLDEN_SAMPLES);
+                if (ratio > spectral) spectral = ratio;
+            }
+        }
+        
+        // Speed over the whole sweep
+        start = bench_now_ns();
+        for (pass = 0; pass < BENCH_GOLDEN_REPEATS; pass++) {
+            for (k = 0; k < golden->count; k++) {
+                bench_render_point(engine, golden->points + k, golden->tables + k * (BENCH_TABLE_SIZE + 1), out);
+            }
+        }
+        ns = (bench_now_ns() - start) / ((double)BENCH_GOLDEN_REPEATS * golden->count * BENCH_GOLDEN_SAMPLES);
+        if (engine == BENCH_SCALAR) reference_ns = ns;
+        
+        if (max_error > bench_golden_tolerance[engine]) failures++;
+        printf("%-10s %12.2f %8.2fx %14.3g %13.1f %11.0e  %s", bench_golden_engines[engine], ns,
+               reference_ns / ns, max_error, spectral > 0.0 ? 20.0 * log10(spectral) : -400.0,
+               bench_golden_tolerance[engine], max_error > bench_golden_tolerance[engine] ? "FAIL" : "ok");
+        if (max_error > 0.0) {
+            const t_bench_point *pt = golden->points + worst;
+            
+            printf("  (worst: type %ld param %.3f damping %.3f freq %.2f %s)", pt->type, pt->param, pt->damping,
+                   pt->freq, pt->looping ? "looping" : "envelope");
+        }
+        printf("\n");
+    }
+    return failures;
+}
+
+//----------------------------------------------------------------------------------------------
+
+static void bench_timing(double seconds, double freq, long blocks, long rates) {
+    double checksum = 0.0;
+    long type, engine, b, r, p, d;
+    
+    bench_counter_open();
+    printf("physicslfo_bench: simd %s (%d lanes), %.2f s of audio per point at %.2f Hz, instructions %s\n",
+           VD_BACKEND, VD_LANES, seconds, freq, bench_counter >= 0 ? "from perf events" : "unavailable");
+    printf("%-5s %-10s %6s %7s %12s %14s\n", "type", "engine", "block", "sr", "ns/sample", "instr/sample");
+    
+    for (type = 0; type < 6; type++) {
+        for (engine = 0; engine < BENCH_ENGINES; engine++) {
+            for (b = 0; b < blocks; b++) {
+                for (r = 0; r < rates; r++) {
+                    long block = bench_blocks[b];
+                    long samples = ((long)(seconds * bench_rates[r]) / block + 1) * block;
+                    double ns = 0.0;
+                    double instructions = 0.0;
+                    long total = 0;
+                    
+                    for (p = 0; p < BENCH_COUNT(bench_params); p++) {
+                        for (d = 0; d < BENCH_COUNT(bench_dampings); d++) {
+                            double count;
+                            
+                            ns += bench_run(engine, type, block, bench_rates[r], freq, samples,
+                                            bench_params[p], bench_dampings[d], &count, &checksum);
+                            instructions = (count < 0.0 || instructions < 0.0) ? -1.0 : instructions + count;
+                            total += samples;
+                        }
+                    }
+                    
+                    if (instructions >= 0.0) {
+                        printf("%-5ld %-10s %6ld %7.0f %12.2f %14.1f\n", type, bench_engine_names[engine], block,
+                               bench_rates[r], ns / total, instructions / total);
+                    } else {
+                        printf("%-5ld %-10s %6ld %7.0f %12.2f %14s\n", type, bench_engine_names[engine], block,
+                               bench_rates[r], ns / total, "n/a");
+                    }
+                }
+            }
+        }
+    }
+    
+    // Keeps the renders observable so nothing is optimized away
+    printf("checksum %.6f\n", checksum);
+}
+
+static int bench_usage(const char *name) {
+    fprintf(stderr, "usage: %s [--seconds <s>] [--freq <hz>] [--quick]\n"
+                    "       %s --write-golden <file>\n"
+                    "       %s --compare [<file>]\n", name, name, name);
+    return 2;
+}
+
+int main(int argc, char **argv) {
+    double seconds = 1.0;
+    double freq = 2.0;
+    long blocks = BENCH_COUNT(bench_blocks);
+    long rates = BENCH_COUNT(bench_rates);
+    const char *golden_path = NULL;
+    int write_golden = 0;
+    int compare = 0;
+    int i;
+    
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--seconds") && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--freq") && i + 1 < argc) {
+            freq = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--quick")) {
+            seconds = 0.1;
+            blocks = 2;     // 16 and 64
+            rates = 1;      // 44100
+        } else if (!strcmp(argv[i], "--write-golden") && i + 1 < argc) {
+            write_golden = 1;
+            golden_path = argv[++i];
+        } else if (!strcmp(argv[i], "--compare")) {
+            compare = 1;
+            if (i + 1 < argc && argv[i + 1][0] != '-') golden_path = argv[++i];
+        } else {
+            return bench_usage(argv[0]);
+        }
+    }
+    if (seconds <= 0.0 || freq < 0.0) {
+        fprintf(stderr, "physicslfo_bench: --seconds must be > 0 and --freq >= 0\n");
+        return 2;
+    }
+    
+    if (write_golden || compare) {
+        t_bench_golden golden;
+        int failures;
+        
+        bench_golden_points(&golden);
+        if (!bench_golden_alloc(&golden)) {
+            bench_golden_free(&golden);
+            fprintf(stderr, "physicslfo_bench: out of memory\n");
+            return 2;
+        }
+        
+        if (write_golden) {
+            bench_golden_reference(&golden);
+            if (!bench_golden_write(&golden, golden_path)) {
+                fprintf(stderr, "physicslfo_bench: could not write %s\n", golden_path);
+                return 2;
+            }
+            printf("physicslfo_bench: wrote %ld reference renders of %d samples to %s\n", golden.count,
+                   BENCH_GOLDEN_SAMPLES, golden_path);
+            bench_golden_free(&golden);
+            return 0;
+        }
+        
+        if (golden_path) {
+            if (!bench_golden_read(&golden, golden_path)) {
+                fprintf(stderr, "physicslfo_bench: %s is missing or from a different sweep\n", golden_path);
+                return 2;
+            }
+            printf("physicslfo_bench: simd %s (%d lanes), comparing against %s\n", VD_BACKEND, VD_LANES,
+                   golden_path);
+        } else {
+            bench_golden_reference(&golden);
+            printf("physicslfo_bench: simd %s (%d lanes), comparing against a live scalar reference\n",
+                   VD_BACKEND, VD_LANES);
+        }
+        failures = bench_compare(&golden);
+        bench_golden_free(&golden);
+        return failures ? 1 : 0;
+    }
+    
+    bench_timing(seconds, freq, blocks, rates);
+    return 0;
+}
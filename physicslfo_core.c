@@ -0,0 +1,1383 @@
+/**
+ * physicslfo_core.c - Physics curve engine for physicslfo~ (no Max SDK dependency)
+ *
+ * See physicslfo_core.h for the API. The Max external links this file into the
+ * module; physicslfo_bench links it on its own.
+ */
+
+#include <string.h>
+
+#include "physicslfo_core.h"
+
+//----------------------------------------------------------------------------------------------
+// Physics State
+//----------------------------------------------------------------------------------------------
+
+// @jitter: one draw per cycle from the voice's stream. The start energy drops
+// by up to the energy amount, damping and physics move by up to their amounts
+// either way, and the constants are rebuilt for the rest of the block.
+static void physics_jitter_draw(t_physics_voice *v) {
+    uint64_t n = v->jitter_draws++ * PHYSICS_JITTER_AMOUNTS;
+    
+    v->energy = 1.0 - v->jitter[PHYSICS_JITTER_ENERGY] * physics_random_unit(v->jitter_key, n);
+    v->damping_offset = v->jitter[PHYSICS_JITTER_DAMPING] * (2.0 * physics_random_unit(v->jitter_key, n + 1) - 1.0);
+    v->param_offset = v->jitter[PHYSICS_JITTER_PHYSICS] * (2.0 * physics_random_unit(v->jitter_key, n + 2) - 1.0);
+    physics_voice_coefs(v, v->param_base, v->damping_base);
+}
+
+void reset_physics_state(t_physics_voice *v) {
+    v->velocity = 0.0;
+    v->acceleration = 0.0;
+    v->energy = 1.0;           // Full energy at start
+    v->bounce_count = 0.0;
+    v->spin_phase = 0.0;
+    v->plugin_type = -1;       // A plugin type resets its own state before the next segment
+    
+    if (v->jitter_on) {
+        physics_jitter_draw(v);
+    }
+}
+
+void physics_voice_get_state(const t_physics_voice *v, t_physics_voice_state *state) {
+    state->phase = v->phase;
+    state->energy = v->energy;
+    state->bounce_count = v->bounce_count;
+    state->velocity = v->velocity;
+    state->spin_phase = v->spin_phase;
+    state->envelope_active = v->envelope_active;
+}
+
+// Continue from a saved state: the curves only depend on these fields and t,
+// so the next sample carries on where the saved voice left off. Plugin types
+// start their own state over.
+void physics_voice_set_state(t_physics_voice *v, const t_physics_voice_state *state) {
+    physics_voice_set_phase(v, state->phase);
+    v->energy = state->energy;
+    v->bounce_count = state->bounce_count;
+    v->velocity = state->velocity;
+    v->spin_phase = state->spin_phase;
+    v->envelope_active = state->envelope_active;
+    v->acceleration = 0.0;
+    v->idle = 0;
+    v->plugin_type = -1;
+}
+
+void physics_coefs_build(t_physics_coefs *coefs, double param, double damping) {
+    coefs->param = param;
+    coefs->damping = damping;
+    
+    coefs->bounce_curve_power = 0.5 + param * 3.0;
+    coefs->bounce_energy_loss = 1.0 - damping * 0.8;
+    
+    coefs->elastic_osc_frequency = 3.0 + param * 12.0;
+    coefs->elastic_omega = 2.0 * PI * coefs->elastic_osc_frequency;
+    coefs->elastic_decay_rate = 1.0 + damping * 4.0;
+    
+    coefs->spin_curve_power = 0.3 + param * 2.5;
+    coefs->spin_primary_freq = 3.0 + param * 12.0;
+    coefs->spin_secondary_freq = 1.5 + param * 6.0;
+    coefs->spin_wobble_freq = 0.5 + param * 1.5;
+    coefs->spin_primary_omega = 2.0 * PI * coefs->spin_primary_freq;
+    coefs->spin_secondary_omega = 2.0 * PI * coefs->spin_secondary_freq;
+    coefs->spin_wobble_omega = 2.0 * PI * coefs->spin_wobble_freq;
+    coefs->spin_base_influence = 0.3 + param * 0.4;
+    coefs->spin_wobble_depth = 0.15 * param;
+    coefs->spin_energy_loss = 1.0 - damping * 0.5;
+    
+    coefs->overshoot_freq = 1.0 + param * 4.0;
+    coefs->overshoot_omega = 2.0 * PI * coefs->overshoot_freq;
+    coefs->overshoot_amount = 0.3 + param * 0.4;
+    coefs->overshoot_approach_rate = 2.0 + damping * 3.0;
+    
+    coefs->multibounce_per_cycle = 2.0 + param * 6.0;
+    coefs->multibounce_energy_loss = 0.5 + damping * 0.4;
+    coefs->multibounce_log_loss = log(coefs->multibounce_energy_loss);
+    
+    coefs->wobble_freq1 = 1.5 + param * 2.5;
+    coefs->wobble_freq2 = coefs->wobble_freq1 + param * 0.8;
+    coefs->wobble_omega1 = 2.0 * PI * coefs->wobble_freq1;
+    coefs->wobble_omega2 = 2.0 * PI * coefs->wobble_freq2;
+    coefs->wobble_approach_rate = 1.5 + damping * 2.0;
+}
+
+// Envelope mode after the first cycle: every curve only decays from here on.
+// Returns 1, with the value the curve settles to, when every sample from phase
+// t on stays within PHYSICS_SETTLE_EPSILON of it. The bounds only shrink as t
+// grows and as the energy falls, so a block that starts settled stays settled.
+int physics_settled(const t_physics_voice *v, long type, double t, const t_physics_coefs *coefs, double *value) {
+    switch (type) {
+        case 0:  // On the ground from t = 1 on
+            *value = 0.0;
+            return t >= 1.0;
+        case 1:  // |output| <= decay envelope
+            *value = 0.0;
+            return exp(-coefs->elastic_decay_rate * t) < PHYSICS_SETTLE_EPSILON;
+        case 2:  // From t = 1 on the trajectory is <= 0, and the height is that times
+                 // 1 + influence * boost * spin + wobble. When that factor can't reach
+                 // zero the output is exactly 0, and it only grows as the energy falls
+            *value = 0.0;
+            return t >= 1.0 &&
+                   coefs->spin_base_influence * (1.0 + 0.5 * v->energy) + coefs->spin_wobble_depth < 1.0;
+        case 3:  // Oscillation cut off, approach within epsilon of equilibrium
+            *value = 0.6;
+            return exp(-coefs->damping * t * 2.5) < 0.01 &&
+                   0.6 * exp(-coefs->overshoot_approach_rate * t) < PHYSICS_SETTLE_EPSILON;
+        case 4:  // Bounce amplitude below the stop threshold
+            *value = 0.0;
+            return exp(floor(t * coefs->multibounce_per_cycle) * coefs->multibounce_log_loss) < 0.02;
+        case 5:  // Wobble cut off, approach within epsilon of equilibrium
+            *value = 0.5;
+            return exp(-coefs->damping * t * 1.2) < 0.01 &&
+                   0.5 * exp(-coefs->wobble_approach_rate * t) < PHYSICS_SETTLE_EPSILON;
+    }
+    return 0;
+}
+
+// Collision state of n settled samples that were not rendered: types 0 and 2
+// are on the ground for every one of them, the other types keep no state
+void physics_settled_advance(t_physics_voice *v, long type, long n, const t_physics_coefs *coefs) {
+    if (type == 0) {
+        v->energy *= pow(coefs->bounce_energy_loss, (double)n);
+        v->bounce_count += (double)n;
+    } else if (type == 2) {
+        v->energy *= pow(coefs->spin_energy_loss, (double)n);
+        v->bounce_count += (double)n;
+    }
+}
+
+//----------------------------------------------------------------------------------------------
+// Block Render API
+//----------------------------------------------------------------------------------------------
+
+// Steady controls: the phase of every sample is written into out, then the
+// block kernels (or the recursive engine) turn it into physics values in place.
+// flags is a combination of PHYSICS_RENDER_RECURSIVE and PHYSICS_RENDER_SINGLE.
+// A looping wrap resets the physics state, so the segment before it is rendered
+// first. This is the float-controlled fast path of the external.
+void physics_voice_render(t_physics_voice *v, long type, double *out, long n, double param, double damping,
+                          double inc, long looping, int flags) {
+    double recursive_dt = (flags & PHYSICS_RENDER_RECURSIVE) ? physics_phase_increment(v, inc) : 0.0;
+    int single = (flags & PHYSICS_RENDER_SINGLE) != 0;
+    double phase = v->phase;
+    long segment = 0;
+    long i;
+    
+    physics_voice_coefs(v, param, damping);
+    
+    for (i = 0; i < n; i++) {
+        if (physicslfo_advance_phase(v, looping, &phase, inc, 0.0)) {
+            physicslfo_render_segment(v, type, out + segment, i - segment, &v->coefs, recursive_dt, single);
+            reset_physics_state(v);
+            segment = i;
+        }
+        out[i] = phase;
+    }
+    physicslfo_render_segment(v, type, out + segment, n - segment, &v->coefs, recursive_dt, single);
+    
+    if (n > 0) {
+        v->last_value = out[n - 1];
+    }
+    v->phase = phase;
+}
+
+// Render one looping cycle into data[0..size] with band-limiting: every point is
+// the average of oversample sub-samples centered on it, which softens
+// ground-contact corners instead of aliasing them into the table. The filter
+// stops at the cycle boundaries, so the first point and the guard point hold
+// the start and end of the cycle and the reset at the wrap stays a clean jump.
+// Sub-samples are evaluated in phase order so the collision state evolves
+// exactly as it would during playback.
+void physics_cycle_render(long type, double param, double damping, double *data, long size, long oversample) {
+    t_physics_voice scratch;
+    t_physics_coefs coefs;
+    long count = size * oversample;
+    long i;
+    
+    memset(&scratch, 0, sizeof(scratch));
+    reset_physics_state(&scratch);
+    physics_coefs_build(&coefs, param, damping);
+    
+    for (i = 0; i <= size; i++) {
+        data[i] = 0.0;
+    }
+    
+    for (i = 0; i < count; i++) {
+        double t = (i + 0.5) / count;
+        long cell = (i + oversample / 2) / oversample;    // 0 to size, half cells at both ends
+        double value = 0.0;
+        
+        switch (type) {
+            case 0:  value = simulate_bounce(&scratch, t, &coefs); break;
+            case 1:  value = simulate_elastic(&scratch, t, &coefs); break;
+            case 2:  value = simulate_bounce_spin(&scratch, t, &coefs); break;
+            case 3:  value = simulate_elastic_overshoot(&scratch, t, &coefs); break;
+            case 4:  value = simulate_multibounce(&scratch, t, &coefs); break;
+            case 5:  value = simulate_wobble(&scratch, t, &coefs); break;
+        }
+        data[cell] += value;
+    }
+    
+    // The guard point past the last entry is the end of the cycle, so playback
+    // never interpolates across the wrap
+    for (i = 1; i < size; i++) {
+        data[i] /= oversample;
+    }
+    data[0] /= oversample / 2;
+    data[size] /= oversample / 2;
+}
+
+//----------------------------------------------------------------------------------------------
+// Physics Simulation Functions
+//----------------------------------------------------------------------------------------------
+// Everything that only depends on the physics parameter and damping comes from
+// the precomputed coefs (see physics_coefs_build); only t-dependent terms are
+// evaluated per sample.
+
+double simulate_bounce(t_physics_voice *v, double t, const t_physics_coefs *coefs) {
+    // Simple bounce: param controls how "bouncy" vs "droopy" the curve is
+    // param = 0.0: very droopy (slow fall, sharp bounce)
+    // param = 1.0: very bouncy (fast fall, high bounce)
+    
+    // Apply continuous damping throughout the bounce cycle
+    // Higher damping = lower overall energy and faster decay
+    double decay_factor = 1.0 - (coefs->damping * t * 1.5);  // More dramatic continuous energy loss
+    double bounce_height = v->energy * fmax(0.1, decay_factor);  // Don't go below 10%
+    
+    // Simple parabolic trajectory with variable curve sharpness
+    // Higher param = sharper, more "bouncy" curve
+    double height = bounce_height * (1.0 - pow(t, coefs->bounce_curve_power));
+    
+    // Ground collision and additional energy loss
+    if (height <= 0.0) {
+        height = 0.0;
+        v->energy *= coefs->bounce_energy_loss;  // Even more dramatic energy loss on bounce
+        v->bounce_count += 1.0;
+    }
+    
+    return CLAMP(height, 0.0, 1.0);
+}
+
+double simulate_elastic(t_physics_voice *v, double t, const t_physics_coefs *coefs) {
+    // Damped oscillation - decay envelope with vibrations inside (like struck bell or plucked string)
+    
+    // Exponential decay envelope - starts at 1.0 and decays toward 0
+    double decay_envelope = exp(-coefs->elastic_decay_rate * t);
+    
+    // Slight frequency drift as energy dissipates (like real physical systems)
+    double freq_drift = 1.0 - (t * 0.1 * coefs->param);  // Slight frequency drop over time
+    freq_drift = fmax(0.8, freq_drift);  // Don't let it drift too much
+    
+    // Oscillation inside the decay envelope
+    double oscillation = sin(coefs->elastic_omega * freq_drift * t);
+    
+    // Combine: oscillation amplitude modulated by decay envelope
+    double result = decay_envelope * oscillation;
+    
+    // Scale and offset to 0-1 range (decay starts high, oscillates toward zero)
+    result = (result + 1.0) * 0.5;  // Convert from ±1 to 0-1
+    result *= decay_envelope;       // Apply envelope again for proper decay to zero
+    
+    return result;
+}
+
+double simulate_bounce_spin(t_physics_voice *v, double t, const t_physics_coefs *coefs) {
+    // Enhanced bounce with dynamic spin - more movement and character
+    
+    // Apply continuous damping with spin-dependent energy retention
+    double decay_factor = 1.0 - (coefs->damping * t * 1.0);  // Slower decay for more movement
+    double bounce_height = v->energy * fmax(0.15, decay_factor);
+    
+    // Basic bounce trajectory
+    double base_bounce = bounce_height * (1.0 - pow(t, coefs->spin_curve_power));
+    
+    // Create complex spin pattern with multiple frequencies
+    double primary_spin = sin(coefs->spin_primary_omega * t);
+    double secondary_spin = sin(coefs->spin_secondary_omega * t + PI/3);  // Phase offset
+    double complex_spin = (primary_spin * 0.7) + (secondary_spin * 0.3);  // Mix harmonics
+    
+    // Dynamic spin influence that increases with parameter and bounce energy
+    double energy_boost = 1.0 + (v->energy * 0.5);   // More spin when more energy
+    double spin_influence = coefs->spin_base_influence * base_bounce * energy_boost;
+    
+    // Add wobble effect - slower frequency modulation
+    double wobble = sin(coefs->spin_wobble_omega * t) * 0.15 * coefs->param;  // Subtle wobble
+    
+    // Combine all effects
+    double final_height = base_bounce + (complex_spin * spin_influence) + (wobble * base_bounce);
+    
+    // Ground collision and energy loss (less aggressive to maintain movement)
+    if (final_height <= 0.0) {
+        final_height = 0.0;
+        v->energy *= coefs->spin_energy_loss;  // Reduced energy loss for more bounces
+        v->bounce_count += 1.0;
+    }
+    
+    return fmax(0.0, final_height);
+}
+
+double simulate_elastic_overshoot(t_physics_voice *v, double t, const t_physics_coefs *coefs) {
+    // Step response with overshoot that settles to equilibrium
+    
+    // Target equilibrium (where it eventually settles)
+    double equilibrium = 0.6;
+    
+    // Exponential approach to equilibrium with proper settling
+    double base_approach = equilibrium * (1.0 - exp(-coefs->overshoot_approach_rate * t));
+    
+    // Overshoot oscillation that properly decays to zero
+    double overshoot_decay = exp(-coefs->damping * t * 2.5);  // Stronger decay
+    
+    // Cut off oscillations when they become negligible
+    if (overshoot_decay < 0.01) {
+        return base_approach;
+    }
+    
+    return base_approach + sin(coefs->overshoot_omega * t) * coefs->overshoot_amount * overshoot_decay;
+}
+
+double simulate_multibounce(t_physics_voice *v, double t, const t_physics_coefs *coefs) {
+    // Multiple bounces that eventually come to complete rest
+    
+    // Which bounce segment are we in?
+    double segment_phase = fmod(t * coefs->multibounce_per_cycle, 1.0);
+    long current_bounce = (long)(t * coefs->multibounce_per_cycle);
+    
+    // Parabolic trajectory for each bounce
+    double height = 4.0 * segment_phase * (1.0 - segment_phase);
+    
+    // More aggressive exponential decay per bounce
+    double bounce_amplitude = pow(coefs->multibounce_energy_loss, current_bounce);
+    
+    // Complete stop when amplitude becomes negligible
+    double stop_threshold = 0.02;  // Stop when below 2%
+    if (bounce_amplitude < stop_threshold) {
+        return 0.0;  // Complete rest
+    }
+    
+    return height * bounce_amplitude;
+}
+
+double simulate_wobble(t_physics_voice *v, double t, const t_physics_coefs *coefs) {
+    // Wobble that eventually settles to equilibrium position
+    
+    // Equilibrium position where wobble settles
+    double equilibrium = 0.5;
+    
+    // Approach equilibrium over time
+    double base_level = equilibrium * (1.0 - exp(-coefs->wobble_approach_rate * t));
+    
+    // Wobble oscillations that properly decay to zero
+    double wobble_decay = exp(-coefs->damping * t * 1.2);  // Stronger decay than before
+    
+    // Cut off wobble when it becomes negligible
+    if (wobble_decay < 0.01) {
+        return base_level;
+    }
+    
+    // Create smooth beating pattern
+    double osc1 = sin(coefs->wobble_omega1 * t);
+    double osc2 = sin(coefs->wobble_omega2 * t);
+    double beating = (osc1 + osc2 * 0.8) / 1.8;     // Weighted average
+    
+    // Combine equilibrium approach with decaying wobble
+    return base_level + (beating * (0.3 * wobble_decay));
+}
+
+//----------------------------------------------------------------------------------------------
+// Block Kernels
+//----------------------------------------------------------------------------------------------
+// Vectorized versions of the simulate_* functions above, used when type, physics
+// parameter and damping are constant for the block. They follow the scalar
+// formulas term for term, with libm replaced by the polynomial approximations in
+// physicslfo_simd.h (see that file for the error bounds). The phase is
+// non-decreasing within a segment since frequency is never negative.
+
+// Load/store up to VD_LANES samples, padding short tails through a scratch vector
+PHYSICSLFO_INLINE vd physicslfo_load_lanes(const double *p, long lanes) {
+    double tmp[VD_LANES] = { 0.0 };
+    
+    if (lanes == VD_LANES) return vd_loadu(p);
+    memcpy(tmp, p, lanes * sizeof(double));
+    return vd_loadu(tmp);
+}
+
+PHYSICSLFO_INLINE void physicslfo_store_lanes(double *p, vd v, long lanes) {
+    double tmp[VD_LANES];
+    
+    if (lanes == VD_LANES) {
+        vd_storeu(p, v);
+        return;
+    }
+    vd_storeu(tmp, v);
+    memcpy(p, tmp, lanes * sizeof(double));
+}
+
+// Ground contact of types 0 and 2 is scheduled instead of tested per sample.
+// (1 - t^power) is positive for t < 1 and <= 0 from t = 1 on, so the first
+// contact is the first sample with t >= 1. Phases never decrease within a
+// segment, which makes that a binary search.
+PHYSICSLFO_INLINE long physicslfo_first_contact(const double *buf, long n) {
+    long lo = 0, hi = n;
+    
+    while (lo < hi) {
+        long mid = lo + (hi - lo) / 2;
+        
+        if (buf[mid] >= 1.0) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo;
+}
+
+// Type 0 past ground contact: every sample is on the ground, so the output is 0
+// and each sample costs one collision, applied to the state in one step
+PHYSICSLFO_INLINE void physicslfo_bounce_rest(t_physics_voice *v, long samples, double energy_loss) {
+    if (samples > 0) {
+        v->energy *= pow(energy_loss, (double)samples);
+        v->bounce_count += (double)samples;
+    }
+}
+
+void render_physics_block(t_physics_voice *v, long type, double *buf, long n, const t_physics_coefs *coefs) {
+    if (n <= 0) return;
+    
+    switch (type) {
+        case 0: simulate_bounce_block(v, buf, n, coefs); break;
+        case 1: simulate_elastic_block(v, buf, n, coefs); break;
+        case 2: simulate_bounce_spin_block(v, buf, n, coefs); break;
+        case 3: simulate_elastic_overshoot_block(v, buf, n, coefs); break;
+        case 4: simulate_multibounce_block(v, buf, n, coefs); break;
+        case 5: simulate_wobble_block(v, buf, n, coefs); break;
+    }
+}
+
+void simulate_bounce_block(t_physics_voice *v, double *buf, long n, const t_physics_coefs *coefs) {
+    vd curve_power = vd_set1(coefs->bounce_curve_power);
+    vd decay_slope = vd_set1(-coefs->damping * 1.5);
+    vd zero = vd_set1(0.0);
+    vd one = vd_set1(1.0);
+    vd energy = vd_set1(v->energy);
+    long contact = v->energy > 0.0 ? physicslfo_first_contact(buf, n) : 0;
+    long i;
+    
+    // In the air: no collision can happen, so the energy is constant
+    for (i = 0; i < contact; i += VD_LANES) {
+        long lanes = contact - i < VD_LANES ? contact - i : VD_LANES;
+        vd t = physicslfo_load_lanes(buf + i, lanes);
+        
+        vd decay_factor = vd_max(vd_set1(0.1), vd_fmadd(decay_slope, t, one));
+        vd height = vd_mul(vd_mul(energy, decay_factor), vd_sub(one, vd_pow_pos(t, curve_power)));
+        
+        physicslfo_store_lanes(buf + i, vd_min(vd_max(height, zero), one), lanes);
+    }
+    
+    // On the ground for the rest of the segment
+    for (i = contact; i < n; i++) {
+        buf[i] = 0.0;
+    }
+    physicslfo_bounce_rest(v, n - contact, coefs->bounce_energy_loss);
+}
+
+void simulate_elastic_block(t_physics_voice *v, double *buf, long n, const t_physics_coefs *coefs) {
+    vd osc_frequency = vd_set1(coefs->elastic_osc_frequency);
+    vd neg_decay_rate = vd_set1(-coefs->elastic_decay_rate);
+    vd drift_slope = vd_set1(-0.1 * coefs->param);
+    vd one = vd_set1(1.0);
+    vd half = vd_set1(0.5);
+    long i;
+    
+    for (i = 0; i < n; i += VD_LANES) {
+        long lanes = n - i < VD_LANES ? n - i : VD_LANES;
+        vd t = physicslfo_load_lanes(buf + i, lanes);
+        
+        vd decay_envelope = vd_exp(vd_mul(neg_decay_rate, t));
+        vd freq_drift = vd_max(vd_set1(0.8), vd_fmadd(t, drift_slope, one));
+        vd oscillation = vd_sin2pi(vd_mul(vd_mul(osc_frequency, freq_drift), t));
+        vd result = vd_mul(decay_envelope, oscillation);
+        
+        result = vd_mul(vd_add(result, one), half);
+        result = vd_mul(result, decay_envelope);
+        
+        physicslfo_store_lanes(buf + i, result, lanes);
+    }
+}
+
+// Type 2 lands when its trajectory does (t >= 1, as in type 0) or when a spin
+// trough pulls the height below zero: height = base * (1 + influence * boost *
+// spin + wobble), with |spin| <= 1 and |wobble| <= wobble_depth. When that
+// factor can't reach zero at the current energy, every sample before t = 1 is
+// collision-free. Returns the length of that prefix (0 when troughs can land).
+PHYSICSLFO_INLINE long physicslfo_spin_calm(const t_physics_voice *v, const double *buf, long n,
+                                            const t_physics_coefs *coefs) {
+    double worst = 1.0 - coefs->spin_base_influence * (1.0 + v->energy * 0.5) - coefs->spin_wobble_depth;
+    
+    if (v->energy <= 0.0 || worst <= 1e-9) return 0;
+    return physicslfo_first_contact(buf, n);
+}
+
+// Combine the energy-independent spin terms with the current energy. A
+// collision changes the energy seen by every later sample, so a vector that
+// touches the ground is finished one lane at a time.
+PHYSICSLFO_INLINE void physicslfo_spin_finish(t_physics_voice *v, double *buf, long lanes, vd decay_factor,
+                                              vd trajectory, vd complex_spin, vd wobble,
+                                              const t_physics_coefs *coefs) {
+    double spin_base_influence = coefs->spin_base_influence;
+    double energy_loss = coefs->spin_energy_loss;
+    vd one = vd_set1(1.0);
+    vd energy = vd_set1(v->energy);
+    vd base_bounce = vd_mul(vd_mul(energy, decay_factor), trajectory);
+    vd energy_boost = vd_fmadd(energy, vd_set1(0.5), one);
+    vd spin_influence = vd_mul(vd_mul(vd_set1(spin_base_influence), base_bounce), energy_boost);
+    vd final_height = vd_add(vd_add(base_bounce, vd_mul(complex_spin, spin_influence)), vd_mul(wobble, base_bounce));
+    
+    if (vd_any(vd_le(final_height, vd_set1(0.0)))) {
+        double df[VD_LANES], tr[VD_LANES], cs[VD_LANES], wb[VD_LANES];
+        long lane;
+        
+        vd_storeu(df, decay_factor);
+        vd_storeu(tr, trajectory);
+        vd_storeu(cs, complex_spin);
+        vd_storeu(wb, wobble);
+        
+        for (lane = 0; lane < lanes; lane++) {
+            double base = v->energy * df[lane] * tr[lane];
+            double influence = spin_base_influence * base * (1.0 + v->energy * 0.5);
+            double height = base + (cs[lane] * influence) + (wb[lane] * base);
+            
+            if (height <= 0.0) {
+                height = 0.0;
+                v->energy *= energy_loss;
+                v->bounce_count += 1.0;
+            }
+            buf[lane] = height;
+        }
+    } else {
+        physicslfo_store_lanes(buf, final_height, lanes);
+    }
+}
+
+void simulate_bounce_spin_block(t_physics_voice *v, double *buf, long n, const t_physics_coefs *coefs) {
+    vd curve_power = vd_set1(coefs->spin_curve_power);
+    vd decay_slope = vd_set1(-coefs->damping);
+    vd primary_spin_freq = vd_set1(coefs->spin_primary_freq);
+    vd secondary_spin_freq = vd_set1(coefs->spin_secondary_freq);
+    vd wobble_freq = vd_set1(coefs->spin_wobble_freq);
+    vd wobble_depth = vd_set1(coefs->spin_wobble_depth);
+    vd one = vd_set1(1.0);
+    long calm = physicslfo_spin_calm(v, buf, n, coefs);
+    long i = 0;
+    
+    // Collision-free prefix: energy is constant, no per-vector ground test
+    if (calm > 0) {
+        vd energy = vd_set1(v->energy);
+        vd energy_boost = vd_fmadd(energy, vd_set1(0.5), one);
+        vd spin_scale = vd_mul(vd_set1(coefs->spin_base_influence), energy_boost);
+        
+        for (i = 0; i < calm; i += VD_LANES) {
+            long lanes = calm - i < VD_LANES ? calm - i : VD_LANES;
+            vd t = physicslfo_load_lanes(buf + i, lanes);
+            
+            vd decay_factor = vd_max(vd_set1(0.15), vd_fmadd(decay_slope, t, one));
+            vd trajectory = vd_sub(one, vd_pow_pos(t, curve_power));
+            vd primary_spin = vd_sin2pi(vd_mul(primary_spin_freq, t));
+            vd secondary_spin = vd_sin2pi(vd_fmadd(secondary_spin_freq, t, vd_set1(1.0 / 6.0)));
+            vd complex_spin = vd_fmadd(primary_spin, vd_set1(0.7), vd_mul(secondary_spin, vd_set1(0.3)));
+            vd wobble = vd_mul(vd_sin2pi(vd_mul(wobble_freq, t)), wobble_depth);
+            vd base_bounce = vd_mul(vd_mul(energy, decay_factor), trajectory);
+            vd spin_influence = vd_mul(spin_scale, base_bounce);
+            vd final_height = vd_add(vd_add(base_bounce, vd_mul(complex_spin, spin_influence)),
+                                     vd_mul(wobble, base_bounce));
+            
+            physicslfo_store_lanes(buf + i, final_height, lanes);
+        }
+        i = calm;
+    }
+    
+    for (; i < n; i += VD_LANES) {
+        long lanes = n - i < VD_LANES ? n - i : VD_LANES;
+        vd t = physicslfo_load_lanes(buf + i, lanes);
+        
+        // Energy-independent terms
+        vd decay_factor = vd_max(vd_set1(0.15), vd_fmadd(decay_slope, t, one));
+        vd trajectory = vd_sub(one, vd_pow_pos(t, curve_power));
+        vd primary_spin = vd_sin2pi(vd_mul(primary_spin_freq, t));
+        vd secondary_spin = vd_sin2pi(vd_fmadd(secondary_spin_freq, t, vd_set1(1.0 / 6.0)));
+        vd complex_spin = vd_fmadd(primary_spin, vd_set1(0.7), vd_mul(secondary_spin, vd_set1(0.3)));
+        vd wobble = vd_mul(vd_sin2pi(vd_mul(wobble_freq, t)), wobble_depth);
+        
+        physicslfo_spin_finish(v, buf + i, lanes, decay_factor, trajectory, complex_spin, wobble, coefs);
+    }
+}
+
+void simulate_elastic_overshoot_block(t_physics_voice *v, double *buf, long n, const t_physics_coefs *coefs) {
+    vd freq = vd_set1(coefs->overshoot_freq);
+    vd overshoot_amount = vd_set1(coefs->overshoot_amount);
+    vd neg_approach_rate = vd_set1(-coefs->overshoot_approach_rate);
+    vd neg_overshoot_rate = vd_set1(-coefs->damping * 2.5);
+    vd equilibrium = vd_set1(0.6);
+    vd one = vd_set1(1.0);
+    long i;
+    
+    for (i = 0; i < n; i += VD_LANES) {
+        long lanes = n - i < VD_LANES ? n - i : VD_LANES;
+        vd t = physicslfo_load_lanes(buf + i, lanes);
+        
+        vd base_approach = vd_mul(equilibrium, vd_sub(one, vd_exp(vd_mul(neg_approach_rate, t))));
+        vd overshoot_decay = vd_exp(vd_mul(neg_overshoot_rate, t));
+        vd overshoot_osc = vd_mul(vd_mul(vd_sin2pi(vd_mul(freq, t)), overshoot_amount), overshoot_decay);
+        
+        // Cut off oscillations when they become negligible
+        overshoot_osc = vd_select(vd_lt(overshoot_decay, vd_set1(0.01)), vd_set1(0.0), overshoot_osc);
+        
+        physicslfo_store_lanes(buf + i, vd_add(base_approach, overshoot_osc), lanes);
+    }
+}
+
+// First sample at or after start whose bounce index (floor(t * per_cycle)) has
+// passed bounce, by binary search over the non-decreasing phases
+PHYSICSLFO_INLINE long physicslfo_next_bounce(const double *buf, long start, long n, double per_cycle, double bounce) {
+    long lo = start, hi = n;
+    
+    while (lo < hi) {
+        long mid = lo + (hi - lo) / 2;
+        
+        if (buf[mid] * per_cycle >= bounce + 1.0) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo;
+}
+
+// The bounce index only changes a few times per cycle, so the amplitude is kept
+// as running state: one exp() at the start of the segment, then one multiply
+// by the energy loss per transition. Each bounce renders as a run with constant
+// amplitude, and once the amplitude is below the stop threshold the rest of
+// the segment is zero-filled.
+void simulate_multibounce_block(t_physics_voice *v, double *buf, long n, const t_physics_coefs *coefs) {
+    double per_cycle = coefs->multibounce_per_cycle;
+    double energy_loss = coefs->multibounce_energy_loss;
+    double bounce, amplitude;
+    vd bounces_per_cycle = vd_set1(per_cycle);
+    vd four = vd_set1(4.0);
+    vd one = vd_set1(1.0);
+    long start = 0;
+    long i;
+    
+    if (n <= 0) return;
+    bounce = floor(buf[0] * per_cycle);
+    amplitude = exp(bounce * coefs->multibounce_log_loss);
+    
+    while (start < n) {
+        long end;
+        vd current_bounce, bounce_amplitude;
+        
+        // Complete stop when amplitude becomes negligible
+        if (amplitude < 0.02) {
+            for (i = start; i < n; i++) {
+                buf[i] = 0.0;
+            }
+            return;
+        }
+        
+        end = physicslfo_next_bounce(buf, start, n, per_cycle, bounce);
+        current_bounce = vd_set1(bounce);
+        bounce_amplitude = vd_set1(amplitude);
+        
+        for (i = start; i < end; i += VD_LANES) {
+            long lanes = end - i < VD_LANES ? end - i : VD_LANES;
+            vd t = physicslfo_load_lanes(buf + i, lanes);
+            
+            vd segment_phase = vd_sub(vd_mul(t, bounces_per_cycle), current_bounce);
+            vd height = vd_mul(vd_mul(four, segment_phase), vd_sub(one, segment_phase));
+            
+            physicslfo_store_lanes(buf + i, vd_mul(height, bounce_amplitude), lanes);
+        }
+        
+        // Next bounce: a single step is one multiply, a jump (very high
+        // frequency) recomputes the amplitude
+        if (end < n) {
+            double next = floor(buf[end] * per_cycle);
+            
+            amplitude = (next == bounce + 1.0) ? amplitude * energy_loss : exp(next * coefs->multibounce_log_loss);
+            bounce = next;
+        }
+        start = end;
+    }
+}
+
+void simulate_wobble_block(t_physics_voice *v, double *buf, long n, const t_physics_coefs *coefs) {
+    vd freq1 = vd_set1(coefs->wobble_freq1);
+    vd freq2 = vd_set1(coefs->wobble_freq2);
+    vd neg_approach_rate = vd_set1(-coefs->wobble_approach_rate);
+    vd neg_wobble_rate = vd_set1(-coefs->damping * 1.2);
+    vd equilibrium = vd_set1(0.5);
+    vd one = vd_set1(1.0);
+    long i;
+    
+    for (i = 0; i < n; i += VD_LANES) {
+        long lanes = n - i < VD_LANES ? n - i : VD_LANES;
+        vd t = physicslfo_load_lanes(buf + i, lanes);
+        
+        vd base_level = vd_mul(equilibrium, vd_sub(one, vd_exp(vd_mul(neg_approach_rate, t))));
+        vd wobble_decay = vd_exp(vd_mul(neg_wobble_rate, t));
+        vd osc1 = vd_sin2pi(vd_mul(freq1, t));
+        vd osc2 = vd_sin2pi(vd_mul(freq2, t));
+        vd beating = vd_div(vd_fmadd(osc2, vd_set1(0.8), osc1), vd_set1(1.8));
+        
+        // Cut off wobble when it becomes negligible
+        vd wobble_amplitude = vd_select(vd_lt(wobble_decay, vd_set1(0.01)), vd_set1(0.0), vd_mul(vd_set1(0.3), wobble_decay));
+        
+        physicslfo_store_lanes(buf + i, vd_fmadd(beating, wobble_amplitude, base_level), lanes);
+    }
+}
+
+
+//----------------------------------------------------------------------------------------------
+// Single-Precision Kernels (@precision single)
+//----------------------------------------------------------------------------------------------
+// The block kernels again, on float32 lanes (vf) with twice the samples per
+// vector. Phases are accumulated in double by the caller, so low frequencies
+// don't drift; they are narrowed per chunk, evaluated in float and widened
+// again for the output. Collision bookkeeping (energy, bounce count) stays in
+// double so a long run of bounces loses no more than the curve evaluation does.
+
+#define PHYSICS_SINGLE_CHUNK 64
+
+PHYSICSLFO_INLINE vf physicslfo_load_lanes_single(const float *p, long lanes) {
+    float tmp[VF_LANES] = { 0.0f };
+    
+    if (lanes == VF_LANES) return vf_loadu(p);
+    memcpy(tmp, p, lanes * sizeof(float));
+    return vf_loadu(tmp);
+}
+
+PHYSICSLFO_INLINE void physicslfo_store_lanes_single(float *p, vf v, long lanes) {
+    float tmp[VF_LANES];
+    
+    if (lanes == VF_LANES) {
+        vf_storeu(p, v);
+        return;
+    }
+    vf_storeu(tmp, v);
+    memcpy(p, tmp, lanes * sizeof(float));
+}
+
+void render_physics_block_single(t_physics_voice *v, long type, double *buf, long n, const t_physics_coefs *coefs) {
+    float chunk[PHYSICS_SINGLE_CHUNK];
+    long start, i;
+    
+    for (start = 0; start < n; start += PHYSICS_SINGLE_CHUNK) {
+        long count = MIN(n - start, PHYSICS_SINGLE_CHUNK);
+        
+        for (i = 0; i < count; i++) {
+            chunk[i] = (float)buf[start + i];
+        }
+        
+        switch (type) {
+            case 0: simulate_bounce_single(v, chunk, count, coefs); break;
+            case 1: simulate_elastic_single(v, chunk, count, coefs); break;
+            case 2: simulate_bounce_spin_single(v, chunk, count, coefs); break;
+            case 3: simulate_elastic_overshoot_single(v, chunk, count, coefs); break;
+            case 4: simulate_multibounce_single(v, chunk, count, coefs); break;
+            case 5: simulate_wobble_single(v, chunk, count, coefs); break;
+        }
+        
+        for (i = 0; i < count; i++) {
+            buf[start + i] = chunk[i];
+        }
+    }
+}
+
+void simulate_bounce_single(t_physics_voice *v, float *buf, long n, const t_physics_coefs *coefs) {
+    vf curve_power = vf_set1((float)coefs->bounce_curve_power);
+    vf decay_slope = vf_set1((float)(-coefs->damping * 1.5));
+    vf zero = vf_set1(0.0f);
+    vf one = vf_set1(1.0f);
+    vf energy = vf_set1((float)v->energy);
+    long contact = 0;
+    long i;
+    
+    // Same contact schedule as simulate_bounce_block; chunks are short, so a linear scan
+    if (v->energy > 0.0) {
+        while (contact < n && buf[contact] < 1.0f) contact++;
+    }
+    
+    for (i = 0; i < contact; i += VF_LANES) {
+        long lanes = contact - i < VF_LANES ? contact - i : VF_LANES;
+        vf t = physicslfo_load_lanes_single(buf + i, lanes);
+        
+        vf decay_factor = vf_max(vf_set1(0.1f), vf_fmadd(decay_slope, t, one));
+        vf height = vf_mul(vf_mul(energy, decay_factor), vf_sub(one, vf_pow_pos(t, curve_power)));
+        
+        physicslfo_store_lanes_single(buf + i, vf_min(vf_max(height, zero), one), lanes);
+    }
+    
+    for (i = contact; i < n; i++) {
+        buf[i] = 0.0f;
+    }
+    physicslfo_bounce_rest(v, n - contact, coefs->bounce_energy_loss);
+}
+
+void simulate_elastic_single(t_physics_voice *v, float *buf, long n, const t_physics_coefs *coefs) {
+    vf osc_frequency = vf_set1((float)coefs->elastic_osc_frequency);
+    vf neg_decay_rate = vf_set1((float)-coefs->elastic_decay_rate);
+    vf drift_slope = vf_set1((float)(-0.1 * coefs->param));
+    vf one = vf_set1(1.0f);
+    vf half = vf_set1(0.5f);
+    long i;
+    
+    for (i = 0; i < n; i += VF_LANES) {
+        long lanes = n - i < VF_LANES ? n - i : VF_LANES;
+        vf t = physicslfo_load_lanes_single(buf + i, lanes);
+        
+        vf decay_envelope = vf_exp(vf_mul(neg_decay_rate, t));
+        vf freq_drift = vf_max(vf_set1(0.8f), vf_fmadd(t, drift_slope, one));
+        vf oscillation = vf_sin2pi(vf_mul(vf_mul(osc_frequency, freq_drift), t));
+        vf result = vf_mul(decay_envelope, oscillation);
+        
+        result = vf_mul(vf_add(result, one), half);
+        result = vf_mul(result, decay_envelope);
+        
+        physicslfo_store_lanes_single(buf + i, result, lanes);
+    }
+}
+
+// physicslfo_spin_finish on float lanes; the per-lane collision path widens to double
+PHYSICSLFO_INLINE void physicslfo_spin_finish_single(t_physics_voice *v, float *buf, long lanes, vf decay_factor,
+                                                     vf trajectory, vf complex_spin, vf wobble,
+                                                     const t_physics_coefs *coefs) {
+    double spin_base_influence = coefs->spin_base_influence;
+    double energy_loss = coefs->spin_energy_loss;
+    vf one = vf_set1(1.0f);
+    vf energy = vf_set1((float)v->energy);
+    vf base_bounce = vf_mul(vf_mul(energy, decay_factor), trajectory);
+    vf energy_boost = vf_fmadd(energy, vf_set1(0.5f), one);
+    vf spin_influence = vf_mul(vf_mul(vf_set1((float)spin_base_influence), base_bounce), energy_boost);
+    vf final_height = vf_add(vf_add(base_bounce, vf_mul(complex_spin, spin_influence)), vf_mul(wobble, base_bounce));
+    
+    if (vf_any(vf_le(final_height, vf_set1(0.0f)))) {
+        float df[VF_LANES], tr[VF_LANES], cs[VF_LANES], wb[VF_LANES];
+        long lane;
+        
+        vf_storeu(df, decay_factor);
+        vf_storeu(tr, trajectory);
+        vf_storeu(cs, complex_spin);
+        vf_storeu(wb, wobble);
+        
+        for (lane = 0; lane < lanes; lane++) {
+            double base = v->energy * df[lane] * tr[lane];
+            double influence = spin_base_influence * base * (1.0 + v->energy * 0.5);
+            double height = base + (cs[lane] * influence) + (wb[lane] * base);
+            
+            if (height <= 0.0) {
+                height = 0.0;
+                v->energy *= energy_loss;
+                v->bounce_count += 1.0;
+            }
+            buf[lane] = (float)height;
+        }
+    } else {
+        physicslfo_store_lanes_single(buf, final_height, lanes);
+    }
+}
+
+void simulate_bounce_spin_single(t_physics_voice *v, float *buf, long n, const t_physics_coefs *coefs) {
+    vf curve_power = vf_set1((float)coefs->spin_curve_power);
+    vf decay_slope = vf_set1((float)-coefs->damping);
+    vf primary_spin_freq = vf_set1((float)coefs->spin_primary_freq);
+    vf secondary_spin_freq = vf_set1((float)coefs->spin_secondary_freq);
+    vf wobble_freq = vf_set1((float)coefs->spin_wobble_freq);
+    vf wobble_depth = vf_set1((float)coefs->spin_wobble_depth);
+    vf one = vf_set1(1.0f);
+    long i;
+    
+    for (i = 0; i < n; i += VF_LANES) {
+        long lanes = n - i < VF_LANES ? n - i : VF_LANES;
+        vf t = physicslfo_load_lanes_single(buf + i, lanes);
+        
+        // Energy-independent terms
+        vf decay_factor = vf_max(vf_set1(0.15f), vf_fmadd(decay_slope, t, one));
+        vf trajectory = vf_sub(one, vf_pow_pos(t, curve_power));
+        vf primary_spin = vf_sin2pi(vf_mul(primary_spin_freq, t));
+        vf secondary_spin = vf_sin2pi(vf_fmadd(secondary_spin_freq, t, vf_set1(1.0f / 6.0f)));
+        vf complex_spin = vf_fmadd(primary_spin, vf_set1(0.7f), vf_mul(secondary_spin, vf_set1(0.3f)));
+        vf wobble = vf_mul(vf_sin2pi(vf_mul(wobble_freq, t)), wobble_depth);
+        
+        physicslfo_spin_finish_single(v, buf + i, lanes, decay_factor, trajectory, complex_spin, wobble, coefs);
+    }
+}
+
+void simulate_elastic_overshoot_single(t_physics_voice *v, float *buf, long n, const t_physics_coefs *coefs) {
+    vf freq = vf_set1((float)coefs->overshoot_freq);
+    vf overshoot_amount = vf_set1((float)coefs->overshoot_amount);
+    vf neg_approach_rate = vf_set1((float)-coefs->overshoot_approach_rate);
+    vf neg_overshoot_rate = vf_set1((float)(-coefs->damping * 2.5));
+    vf equilibrium = vf_set1(0.6f);
+    vf one = vf_set1(1.0f);
+    long i;
+    
+    for (i = 0; i < n; i += VF_LANES) {
+        long lanes = n - i < VF_LANES ? n - i : VF_LANES;
+        vf t = physicslfo_load_lanes_single(buf + i, lanes);
+        
+        vf base_approach = vf_mul(equilibrium, vf_sub(one, vf_exp(vf_mul(neg_approach_rate, t))));
+        vf overshoot_decay = vf_exp(vf_mul(neg_overshoot_rate, t));
+        vf overshoot_osc = vf_mul(vf_mul(vf_sin2pi(vf_mul(freq, t)), overshoot_amount), overshoot_decay);
+        
+        // Cut off oscillations when they become negligible
+        overshoot_osc = vf_select(vf_lt(overshoot_decay, vf_set1(0.01f)), vf_set1(0.0f), overshoot_osc);
+        
+        physicslfo_store_lanes_single(buf + i, vf_add(base_approach, overshoot_osc), lanes);
+    }
+}
+
+// Same running-amplitude scheme as simulate_multibounce_block; chunks are
+// short, so transitions are found by a linear scan
+void simulate_multibounce_single(t_physics_voice *v, float *buf, long n, const t_physics_coefs *coefs) {
+    float per_cycle = (float)coefs->multibounce_per_cycle;
+    double energy_loss = coefs->multibounce_energy_loss;
+    float bounce;
+    double amplitude;
+    vf bounces_per_cycle = vf_set1(per_cycle);
+    vf four = vf_set1(4.0f);
+    vf one = vf_set1(1.0f);
+    long start = 0;
+    long i;
+    
+    if (n <= 0) return;
+    bounce = floorf(buf[0] * per_cycle);
+    amplitude = exp(bounce * coefs->multibounce_log_loss);
+    
+    while (start < n) {
+        long end = start;
+        vf current_bounce, bounce_amplitude;
+        
+        // Complete stop when amplitude becomes negligible
+        if (amplitude < 0.02) {
+            for (i = start; i < n; i++) {
+                buf[i] = 0.0f;
+            }
+            return;
+        }
+        
+        while (end < n && buf[end] * per_cycle < bounce + 1.0f) end++;
+        current_bounce = vf_set1(bounce);
+        bounce_amplitude = vf_set1((float)amplitude);
+        
+        for (i = start; i < end; i += VF_LANES) {
+            long lanes = end - i < VF_LANES ? end - i : VF_LANES;
+            vf t = physicslfo_load_lanes_single(buf + i, lanes);
+            
+            vf segment_phase = vf_sub(vf_mul(t, bounces_per_cycle), current_bounce);
+            vf height = vf_mul(vf_mul(four, segment_phase), vf_sub(one, segment_phase));
+            
+            physicslfo_store_lanes_single(buf + i, vf_mul(height, bounce_amplitude), lanes);
+        }
+        
+        if (end < n) {
+            float next = floorf(buf[end] * per_cycle);
+            
+            amplitude = (next == bounce + 1.0f) ? amplitude * energy_loss : exp(next * coefs->multibounce_log_loss);
+            bounce = next;
+        }
+        start = end;
+    }
+}
+
+void simulate_wobble_single(t_physics_voice *v, float *buf, long n, const t_physics_coefs *coefs) {
+    vf freq1 = vf_set1((float)coefs->wobble_freq1);
+    vf freq2 = vf_set1((float)coefs->wobble_freq2);
+    vf neg_approach_rate = vf_set1((float)-coefs->wobble_approach_rate);
+    vf neg_wobble_rate = vf_set1((float)(-coefs->damping * 1.2));
+    vf equilibrium = vf_set1(0.5f);
+    vf one = vf_set1(1.0f);
+    long i;
+    
+    for (i = 0; i < n; i += VF_LANES) {
+        long lanes = n - i < VF_LANES ? n - i : VF_LANES;
+        vf t = physicslfo_load_lanes_single(buf + i, lanes);
+        
+        vf base_level = vf_mul(equilibrium, vf_sub(one, vf_exp(vf_mul(neg_approach_rate, t))));
+        vf wobble_decay = vf_exp(vf_mul(neg_wobble_rate, t));
+        vf osc1 = vf_sin2pi(vf_mul(freq1, t));
+        vf osc2 = vf_sin2pi(vf_mul(freq2, t));
+        vf beating = vf_div(vf_fmadd(osc2, vf_set1(0.8f), osc1), vf_set1(1.8f));
+        
+        // Cut off wobble when it becomes negligible
+        vf wobble_amplitude = vf_select(vf_lt(wobble_decay, vf_set1(0.01f)), vf_set1(0.0f), vf_mul(vf_set1(0.3f), wobble_decay));
+        
+        physicslfo_store_lanes_single(buf + i, vf_fmadd(beating, wobble_amplitude, base_level), lanes);
+    }
+}
+
+
+//----------------------------------------------------------------------------------------------
+// Recursive Engine (@engine recursive)
+//----------------------------------------------------------------------------------------------
+// With frequency, type, physics and damping steady, the phase advances by a
+// constant dt per sample. Each sin(2 * PI * f * t) term then becomes a rotating
+// phasor and each exp(-rate * t) a multiplicative decay. Lane l of a vector
+// carries sample i + l, so one complex multiply advances every lane by
+// VD_LANES samples. Phasors are reseeded from the closed form at the start of
+// every segment (block start or cycle wrap), which keeps rounding drift bounded
+// by one vector's worth of recurrence steps.
+
+// Phasor for sin(2 * PI * u(t)) with u(t) = a * t + b * t^2 + offset (in turns)
+typedef struct _physics_phasor {
+    vd re, im;                  // exp(i * 2 * PI * u) per lane
+    vd step_re, step_im;        // rotation to the same lane one vector later
+    vd accel_re, accel_im;      // change of that rotation per vector (b != 0 only)
+} t_physics_phasor;
+
+PHYSICSLFO_INLINE void physics_phasor_init(t_physics_phasor *p, vd t, double dt, double a, double b, double offset) {
+    double span = VD_LANES * dt;
+    vd turns = vd_fmadd(vd_fmadd(t, vd_set1(b), vd_set1(a)), t, vd_set1(offset));
+    vd step = vd_mul(vd_set1(span), vd_fmadd(vd_set1(b), vd_fmadd(t, vd_set1(2.0), vd_set1(span)), vd_set1(a)));
+    vd accel = vd_set1(2.0 * b * span * span);
+    vd quarter = vd_set1(0.25);
+    
+    p->im = vd_sin2pi(turns);
+    p->re = vd_sin2pi(vd_add(turns, quarter));
+    p->step_im = vd_sin2pi(step);
+    p->step_re = vd_sin2pi(vd_add(step, quarter));
+    p->accel_im = vd_sin2pi(accel);
+    p->accel_re = vd_sin2pi(vd_add(accel, quarter));
+}
+
+PHYSICSLFO_INLINE void physics_phasor_advance(t_physics_phasor *p, int chirp) {
+    vd re = vd_sub(vd_mul(p->re, p->step_re), vd_mul(p->im, p->step_im));
+    vd im = vd_fmadd(p->re, p->step_im, vd_mul(p->im, p->step_re));
+    
+    p->re = re;
+    p->im = im;
+    if (chirp) {
+        vd step_re = vd_sub(vd_mul(p->step_re, p->accel_re), vd_mul(p->step_im, p->accel_im));
+        vd step_im = vd_fmadd(p->step_re, p->accel_im, vd_mul(p->step_im, p->accel_re));
+    
+        p->step_re = step_re;
+        p->step_im = step_im;
+    }
+}
+
+// Decay exp(-rate * t) per lane, advanced by exp(-rate * VD_LANES * dt)
+typedef struct _physics_decay {
+    vd value;
+    vd step;
+} t_physics_decay;
+
+PHYSICSLFO_INLINE void physics_decay_init(t_physics_decay *d, vd t, double dt, double rate) {
+    d->value = vd_exp(vd_mul(vd_set1(-rate), t));
+    d->step = vd_set1(exp(-rate * VD_LANES * dt));
+}
+
+PHYSICSLFO_INLINE void physics_decay_advance(t_physics_decay *d) {
+    d->value = vd_mul(d->value, d->step);
+}
+
+// Seed time for every lane: the actual phase of the first sample plus lane * dt
+PHYSICSLFO_INLINE vd physicslfo_seed_time(const double *buf, double dt) {
+    double t[VD_LANES];
+    long lane;
+    
+    for (lane = 0; lane < VD_LANES; lane++) {
+        t[lane] = buf[0] + lane * dt;
+    }
+    return vd_loadu(t);
+}
+
+void render_physics_recursive(t_physics_voice *v, long type, double *buf, long n, const t_physics_coefs *coefs, double dt) {
+    if (n <= 0) return;
+    
+    switch (type) {
+        case 1: simulate_elastic_recursive(v, buf, n, coefs, dt); break;
+        case 2: simulate_bounce_spin_recursive(v, buf, n, coefs, dt); break;
+        case 3: simulate_elastic_overshoot_recursive(v, buf, n, coefs, dt); break;
+        case 5: simulate_wobble_recursive(v, buf, n, coefs, dt); break;
+        default: render_physics_block(v, type, buf, n, coefs); break;  // No sin() terms
+    }
+}
+
+void simulate_elastic_recursive(t_physics_voice *v, double *buf, long n, const t_physics_coefs *coefs, double dt) {
+    double tension = coefs->param;
+    double osc_frequency = coefs->elastic_osc_frequency;
+    vd one = vd_set1(1.0);
+    vd half = vd_set1(0.5);
+    t_physics_phasor osc;
+    t_physics_decay envelope;
+    long i;
+    
+    // Frequency drift makes the phase quadratic in t until it clamps at 0.8;
+    // a segment that reaches the clamp uses the closed form instead
+    if (tension > 0.0 && buf[0] + n * dt > 2.0 / tension) {
+        simulate_elastic_block(v, buf, n, coefs);
+        return;
+    }
+    
+    vd t = physicslfo_seed_time(buf, dt);
+    physics_phasor_init(&osc, t, dt, osc_frequency, -0.1 * tension * osc_frequency, 0.0);
+    physics_decay_init(&envelope, t, dt, coefs->elastic_decay_rate);
+    
+    for (i = 0; i < n; i += VD_LANES) {
+        long lanes = n - i < VD_LANES ? n - i : VD_LANES;
+        vd result = vd_mul(envelope.value, osc.im);
+    
+        result = vd_mul(vd_mul(vd_add(result, one), half), envelope.value);
+        physicslfo_store_lanes(buf + i, result, lanes);
+    
+        physics_phasor_advance(&osc, 1);
+        physics_decay_advance(&envelope);
+    }
+}
+
+void simulate_bounce_spin_recursive(t_physics_voice *v, double *buf, long n, const t_physics_coefs *coefs, double dt) {
+    vd curve_power = vd_set1(coefs->spin_curve_power);
+    vd decay_slope = vd_set1(-coefs->damping);
+    vd wobble_depth = vd_set1(coefs->spin_wobble_depth);
+    vd one = vd_set1(1.0);
+    t_physics_phasor primary, secondary, wobble_osc;
+    long i;
+    
+    vd seed = physicslfo_seed_time(buf, dt);
+    physics_phasor_init(&primary, seed, dt, coefs->spin_primary_freq, 0.0, 0.0);
+    physics_phasor_init(&secondary, seed, dt, coefs->spin_secondary_freq, 0.0, 1.0 / 6.0);   // PI/3 phase offset
+    physics_phasor_init(&wobble_osc, seed, dt, coefs->spin_wobble_freq, 0.0, 0.0);
+    
+    for (i = 0; i < n; i += VD_LANES) {
+        long lanes = n - i < VD_LANES ? n - i : VD_LANES;
+        vd t = physicslfo_load_lanes(buf + i, lanes);
+    
+        // pow() has no cheap recurrence, it stays closed form
+        vd decay_factor = vd_max(vd_set1(0.15), vd_fmadd(decay_slope, t, one));
+        vd trajectory = vd_sub(one, vd_pow_pos(t, curve_power));
+        vd complex_spin = vd_fmadd(primary.im, vd_set1(0.7), vd_mul(secondary.im, vd_set1(0.3)));
+        vd wobble = vd_mul(wobble_osc.im, wobble_depth);
+    
+        physicslfo_spin_finish(v, buf + i, lanes, decay_factor, trajectory, complex_spin, wobble, coefs);
+    
+        physics_phasor_advance(&primary, 0);
+        physics_phasor_advance(&secondary, 0);
+        physics_phasor_advance(&wobble_osc, 0);
+    }
+}
+
+void simulate_elastic_overshoot_recursive(t_physics_voice *v, double *buf, long n, const t_physics_coefs *coefs, double dt) {
+    vd overshoot_amount = vd_set1(coefs->overshoot_amount);
+    vd equilibrium = vd_set1(0.6);
+    vd one = vd_set1(1.0);
+    t_physics_phasor osc;
+    t_physics_decay approach, overshoot_decay;
+    long i;
+    
+    vd t = physicslfo_seed_time(buf, dt);
+    physics_phasor_init(&osc, t, dt, coefs->overshoot_freq, 0.0, 0.0);
+    physics_decay_init(&approach, t, dt, coefs->overshoot_approach_rate);
+    physics_decay_init(&overshoot_decay, t, dt, coefs->damping * 2.5);
+    
+    for (i = 0; i < n; i += VD_LANES) {
+        long lanes = n - i < VD_LANES ? n - i : VD_LANES;
+        vd base_approach = vd_mul(equilibrium, vd_sub(one, approach.value));
+        vd overshoot_osc = vd_mul(vd_mul(osc.im, overshoot_amount), overshoot_decay.value);
+    
+        // Cut off oscillations when they become negligible
+        overshoot_osc = vd_select(vd_lt(overshoot_decay.value, vd_set1(0.01)), vd_set1(0.0), overshoot_osc);
+        physicslfo_store_lanes(buf + i, vd_add(base_approach, overshoot_osc), lanes);
+    
+        physics_phasor_advance(&osc, 0);
+        physics_decay_advance(&approach);
+        physics_decay_advance(&overshoot_decay);
+    }
+}
+
+void simulate_wobble_recursive(t_physics_voice *v, double *buf, long n, const t_physics_coefs *coefs, double dt) {
+    vd equilibrium = vd_set1(0.5);
+    vd one = vd_set1(1.0);
+    t_physics_phasor osc1, osc2;
+    t_physics_decay approach, wobble_decay;
+    long i;
+    
+    vd t = physicslfo_seed_time(buf, dt);
+    physics_phasor_init(&osc1, t, dt, coefs->wobble_freq1, 0.0, 0.0);
+    physics_phasor_init(&osc2, t, dt, coefs->wobble_freq2, 0.0, 0.0);
+    physics_decay_init(&approach, t, dt, coefs->wobble_approach_rate);
+    physics_decay_init(&wobble_decay, t, dt, coefs->damping * 1.2);
+    
+    for (i = 0; i < n; i += VD_LANES) {
+        long lanes = n - i < VD_LANES ? n - i : VD_LANES;
+        vd base_level = vd_mul(equilibrium, vd_sub(one, approach.value));
+        vd beating = vd_div(vd_fmadd(osc2.im, vd_set1(0.8), osc1.im), vd_set1(1.8));
+    
+        // Cut off wobble when it becomes negligible
+        vd wobble_amplitude = vd_select(vd_lt(wobble_decay.value, vd_set1(0.01)), vd_set1(0.0),
+                                        vd_mul(vd_set1(0.3), wobble_decay.value));
+        physicslfo_store_lanes(buf + i, vd_fmadd(beating, wobble_amplitude, base_level), lanes);
+    
+        physics_phasor_advance(&osc1, 0);
+        physics_phasor_advance(&osc2, 0);
+        physics_decay_advance(&approach);
+        physics_decay_advance(&wobble_decay);
+    }
+}
+
+//----------------------------------------------------------------------------------------------
+// Decimated Rendering (@decimate)
+//----------------------------------------------------------------------------------------------
+// The curve is only evaluated at anchors every factor samples of a wrap-free
+// segment, plus its last sample, and the samples in between are interpolated
+// against the phase (not the sample index), so frequency changes inside an
+// interval stay in step. Both segment ends are exact, so wraps and triggers
+// keep their hard edges. Anchors are evaluated in phase order with the scalar
+// simulate_* functions, so the collision state only sees anchor phases.
+
+// Oscillations (or bounces) of the fastest term per unit of phase, for the alias guard
+double physics_fastest_rate(long type, const t_physics_coefs *coefs) {
+    switch (type) {
+        case 1:  return coefs->elastic_osc_frequency;
+        case 2:  return coefs->spin_primary_freq;
+        case 3:  return coefs->overshoot_freq;
+        case 4:  return coefs->multibounce_per_cycle;
+        case 5:  return coefs->wobble_freq2;
+    }
+    return 1.0;
+}
+
+void physics_decimated_render(t_physics_voice *v, long type, double *buf, long n, const t_physics_coefs *coefs,
+                              long factor, int cubic) {
+    double t0, t1, t2;          // Phases of the anchors around the current interval
+    double y_prev, y0, y1, y2;  // Values at the previous, current, next and following anchor
+    long a0, a1, a2;            // Sample index of the current, next and following anchor
+    long i;
+    
+    if (n <= 0) return;
+    if (factor < 1) factor = 1;
+    
+    a0 = 0;
+    t0 = buf[0];
+    y0 = y_prev = physics_simulate_at(v, type, t0, coefs);
+    buf[0] = y0;
+    if (n == 1) return;
+    
+    a1 = MIN(factor, n - 1);
+    t1 = buf[a1];
+    y1 = physics_simulate_at(v, type, t1, coefs);
+    
+    while (a0 < n - 1) {
+        double span = t1 - t0;
+        
+        // Cubic needs the anchor after the interval too; the segment end repeats itself
+        a2 = MIN(a1 + factor, n - 1);
+        if (a2 > a1) {
+            t2 = buf[a2];
+            y2 = physics_simulate_at(v, type, t2, coefs);
+        } else {
+            t2 = t1;
+            y2 = y1;
+        }
+        
+        for (i = a0 + 1; i < a1; i++) {
+            double u = span > 0.0 ? (buf[i] - t0) / span : (double)(i - a0) / (a1 - a0);
+            
+            if (cubic) {
+                // Catmull-Rom through the four surrounding anchors
+                buf[i] = y0 + 0.5 * u * (y1 - y_prev + u * (2.0 * y_prev - 5.0 * y0 + 4.0 * y1 - y2 +
+                                                            u * (3.0 * (y0 - y1) + y2 - y_prev)));
+            } else {
+                buf[i] = y0 + u * (y1 - y0);
+            }
+        }
+        buf[a1] = y1;
+        
+        y_prev = y0;
+        a0 = a1; t0 = t1; y0 = y1;
+        a1 = a2; t1 = t2; y1 = y2;
+    }
+}
+
+//----------------------------------------------------------------------------------------------
+// Half-Band Decimation (@oversample)
+//----------------------------------------------------------------------------------------------
+// Every other coefficient of a half-band FIR is zero, apart from the center of
+// 0.5. Split into even and odd input phases, each output is the center sample
+// plus taps symmetric pairs of the other phase, so it costs taps multiplies,
+// and consecutive outputs read consecutive samples of both phases (plain
+// vector loads). Output k is centered on input 2 (k - taps) + 1, the last
+// input of the pair taps outputs earlier: the stage delays by exactly taps
+// output samples.
+
+#define PHYSICS_HALFBAND_BETA 7.0  // Kaiser window, about 70 dB stopband
+
+// Modified Bessel function of order 0, for the Kaiser window
+static double physics_bessel_i0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    
+    for (long k = 1; k < 64 && term > sum * 1e-17; k++) {
+        double half = x / (2.0 * k);
+        
+        term *= half * half;
+        sum += term;
+    }
+    return sum;
+}
+
+// Kaiser-windowed sinc at the odd offsets 1, 3, ... 2 * taps - 1, scaled so
+// the DC gain is exactly 1 (0.5 + 2 * the coefficient sum)
+void physics_halfband_design(double *coefs, long taps) {
+    double norm = physics_bessel_i0(PHYSICS_HALFBAND_BETA);
+    double sum = 0.0;
+    long j;
+    
+    for (j = 0; j < taps; j++) {
+        double offset = 2.0 * j + 1.0;
+        double r = offset / (2.0 * taps);
+        double window = physics_bessel_i0(PHYSICS_HALFBAND_BETA * sqrt(1.0 - r * r)) / norm;
+        
+        coefs[j] = ((j & 1) ? -1.0 : 1.0) / (PI * offset) * window;
+        sum += coefs[j];
+    }
+    for (j = 0; j < taps; j++) {
+        coefs[j] *= 0.25 / sum;
+    }
+}
+
+void physics_halfband_decimate(const double *coefs, long taps, double *history, double *buf, long n, double *work) {
+    long h = PHYSICS_HALFBAND_HISTORY(taps);
+    long half = (h + n) / 2;
+    long outputs = n / 2;
+    double *even = work;
+    double *odd = work + half;
+    long i, j, k;
+    
+    for (i = 0; i < h / 2; i++) {
+        even[i] = history[2 * i];
+        odd[i] = history[2 * i + 1];
+    }
+    for (i = 0; i < outputs; i++) {
+        even[h / 2 + i] = buf[2 * i];
+        odd[h / 2 + i] = buf[2 * i + 1];
+    }
+    
+    // Newest h inputs for the next block
+    if (n >= h) {
+        memcpy(history, buf + n - h, h * sizeof(double));
+    } else {
+        memmove(history, history + n, (h - n) * sizeof(double));
+        memcpy(history + h - n, buf, n * sizeof(double));
+    }
+    
+    for (k = 0; k + VD_LANES <= outputs; k += VD_LANES) {
+        vd acc = vd_mul(vd_set1(0.5), vd_loadu(odd + k + taps - 1));
+        
+        for (j = 0; j < taps; j++) {
+            vd pair = vd_add(vd_loadu(even + k + taps - 1 - j), vd_loadu(even + k + taps + j));
+            
+            acc = vd_fmadd(vd_set1(coefs[j]), pair, acc);
+        }
+        vd_storeu(buf + k, acc);
+    }
+    for (; k < outputs; k++) {
+        double acc = 0.5 * odd[k + taps - 1];
+        
+        for (j = 0; j < taps; j++) {
+            acc += coefs[j] * (even[k + taps - 1 - j] + even[k + taps + j]);
+        }
+        buf[k] = acc;
+    }
+}
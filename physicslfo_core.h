@@ -0,0 +1,428 @@
+/**
+ * physicslfo_core.h - Max-independent physics curve engine behind physicslfo~
+ *
+ * Voice state, per-cycle constants, the six simulate_* curves, the vectorized
+ * block kernels and the recursive engine. Nothing here depends on the Max SDK,
+ * so the same code runs inside the external and in tools such as
+ * physicslfo_bench.
+ *
+ * Block render API:
+ *   physics_voice_render  - n samples of one voice with steady controls
+ *   physics_cycle_render  - one band-limited looping cycle (wavetables)
+ *
+ * Lower-level pieces (used by the external's specialized perform loops):
+ *   simulate_*            - one sample at phase t
+ *   render_physics_block  - vectorized, buf holds phases on entry
+ *   render_physics_block_single - the same on float32 lanes (@precision single)
+ *   render_physics_recursive - phasor/decay recurrences for a constant increment
+ *   physics_decimated_render - anchors every N samples, interpolated (@decimate)
+ *   physicslfo_advance_phase, physicslfo_trigger_edge - shared phase handling
+ *   physics_table_read    - interpolated wavetable lookup (@table)
+ *   physics_voice_set_phase, physics_voice_phase_fixed - fixed-point phase (@accum fixed)
+ *   physics_voice_coefs, physics_random - per-cycle variation (@jitter)
+ *   physics_halfband_design, physics_halfband_decimate - 2:1 stages for @oversample
+ */
+
+#ifndef PHYSICSLFO_CORE_H
+#define PHYSICSLFO_CORE_H
+
+#include <math.h>
+#include <stdint.h>
+
+#include "physicslfo_simd.h"
+#include "physicslfo_plugin.h"
+
+#ifndef PI
+#define PI 3.14159265358979323846
+#endif
+
+// Same definitions as the Max SDK, for builds without it
+#ifndef CLAMP
+#define CLAMP(a, lo, hi) ((a) > (lo) ? ((a) < (hi) ? (a) : (hi)) : (lo))
+#endif
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+// Force inlining of the perform template and loop helpers, so the Max wrapper
+// gets one specialized loop per inlet connection pattern
+#if defined(__GNUC__) || defined(__clang__)
+#define PHYSICSLFO_INLINE static inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define PHYSICSLFO_INLINE static __forceinline
+#else
+#define PHYSICSLFO_INLINE static inline
+#endif
+
+// Per-cycle constants derived from the physics parameter and damping. They only
+// depend on those two values, so they are rebuilt when either changes instead
+// of on every sample.
+typedef struct _physics_coefs {
+    double param;                   // Physics parameter the constants were built from
+    double damping;                 // Damping the constants were built from
+    
+    // Type 0: bounce
+    double bounce_curve_power;      // 0.5 to 3.5 power curve
+    double bounce_energy_loss;      // Energy kept per ground contact
+    
+    // Type 1: damped decay
+    double elastic_osc_frequency;   // 3-15 Hz vibration frequency
+    double elastic_omega;           // 2 * PI * osc_frequency
+    double elastic_decay_rate;      // 1-5 decay rate
+    
+    // Type 2: bounce with spin
+    double spin_curve_power;        // 0.3 to 2.8 power curve
+    double spin_primary_freq;       // 3-15 Hz
+    double spin_secondary_freq;     // 1.5-7.5 Hz
+    double spin_wobble_freq;        // 0.5-2 Hz
+    double spin_primary_omega;      // 2 * PI * frequency for the three spin terms
+    double spin_secondary_omega;
+    double spin_wobble_omega;
+    double spin_base_influence;     // 0.3 to 0.7 influence range
+    double spin_wobble_depth;       // 0.15 * param
+    double spin_energy_loss;        // Energy kept per ground contact
+    
+    // Type 3: elastic overshoot
+    double overshoot_freq;          // 1-5 Hz oscillation frequency
+    double overshoot_omega;         // 2 * PI * overshoot_freq
+    double overshoot_amount;        // 0.3-0.7
+    double overshoot_approach_rate; // 2-5
+    
+    // Type 4: multi-bounce
+    double multibounce_per_cycle;   // 2-8 bounces per cycle
+    double multibounce_energy_loss; // 50-90% energy retained per bounce
+    double multibounce_log_loss;    // log(multibounce_energy_loss)
+    
+    // Type 5: wobble
+    double wobble_freq1;            // Base frequency
+    double wobble_freq2;            // Base frequency plus spread
+    double wobble_omega1;           // 2 * PI * frequency for both oscillators
+    double wobble_omega2;
+    double wobble_approach_rate;    // 1.5-3.5
+} t_physics_coefs;
+
+// Oscillator and physics state of one voice. A multichannel (@chans) instance
+// runs one of these per output channel.
+typedef struct _physics_voice {
+    double phase;               // Current phase (0.0 to 1.0)
+    double velocity;            // Current velocity
+    double acceleration;        // Current acceleration
+    double energy;              // Current energy level (0.0-1.0)
+    double bounce_count;        // Number of bounces occurred
+    double last_value;          // Previous output value
+    double spin_phase;          // Phase for spin calculations
+    long envelope_active;       // 1 when envelope is running, 0 when finished
+    double trigger_prev;        // Last trigger inlet sample, for edge detection across blocks
+    long idle;                  // 1 while a finished envelope has settled (constant output)
+    uint64_t phase_fixed;       // 24.40 fixed-point phase (@accum fixed)
+    long phase_fixed_on;        // 1 when phase is derived from phase_fixed
+    long plugin_type;           // Plugin type plugin_state was reset for, -1 after a reset
+    double plugin_state[PHYSICSLFO_PLUGIN_STATE];   // State of a plugin type (physicslfo_plugin.h)
+    
+    // Per-cycle variation (@jitter), drawn by reset_physics_state at every new cycle
+    double jitter[3];           // Energy, damping and physics amounts (PHYSICS_JITTER_*)
+    long jitter_on;             // 1 when any amount is above 0
+    uint64_t jitter_key;        // Random stream of this voice
+    uint64_t jitter_draws;      // Cycles drawn from the stream so far
+    unsigned long jitter_epoch; // Seed generation the stream was keyed for (external)
+    double param_base;          // Physics and damping before the cycle's offsets
+    double damping_base;
+    double param_offset;        // Offsets drawn for the current cycle
+    double damping_offset;
+    
+    // Event outlet (external)
+    long event_restart;         // 1 after a bang, until the next block reports it
+    double event_prev[2];       // Last two output values, for collision detection
+    
+    t_physics_coefs coefs;      // Constants for the current physics/damping pair
+} t_physics_voice;
+
+// Types 0-5; higher type numbers are plugins registered by the external
+#define PHYSICS_BUILTIN_TYPES 6
+
+// @jitter amounts: start energy lost, damping and physics spread per cycle
+#define PHYSICS_JITTER_ENERGY 0
+#define PHYSICS_JITTER_DAMPING 1
+#define PHYSICS_JITTER_PHYSICS 2
+#define PHYSICS_JITTER_AMOUNTS 3
+
+// Simulation state of a voice as handed between instances (getstate/setstate)
+typedef struct _physics_voice_state {
+    double phase;
+    double energy;
+    double bounce_count;
+    double velocity;
+    double spin_phase;
+    long envelope_active;
+} t_physics_voice_state;
+
+#define PHYSICS_VOICE_STATE_FIELDS 6
+
+// Physics state
+void reset_physics_state(t_physics_voice *v);
+void physics_voice_get_state(const t_physics_voice *v, t_physics_voice_state *state);
+void physics_voice_set_state(t_physics_voice *v, const t_physics_voice_state *state);
+void physics_coefs_build(t_physics_coefs *coefs, double param, double damping);
+
+// Settle detection for finished envelopes: 1 when every sample from phase t on
+// is within PHYSICS_SETTLE_EPSILON of *value
+#define PHYSICS_SETTLE_EPSILON 1e-7
+int physics_settled(const t_physics_voice *v, long type, double t, const t_physics_coefs *coefs, double *value);
+void physics_settled_advance(t_physics_voice *v, long type, long n, const t_physics_coefs *coefs);
+
+// Physics simulation functions
+double simulate_bounce(t_physics_voice *v, double t, const t_physics_coefs *coefs);
+double simulate_elastic(t_physics_voice *v, double t, const t_physics_coefs *coefs);
+double simulate_bounce_spin(t_physics_voice *v, double t, const t_physics_coefs *coefs);
+double simulate_elastic_overshoot(t_physics_voice *v, double t, const t_physics_coefs *coefs);
+double simulate_multibounce(t_physics_voice *v, double t, const t_physics_coefs *coefs);
+double simulate_wobble(t_physics_voice *v, double t, const t_physics_coefs *coefs);
+
+// One sample of any type, for loops where the type is only known at run time
+PHYSICSLFO_INLINE double physics_simulate_at(t_physics_voice *v, long type, double t, const t_physics_coefs *coefs) {
+    switch (type) {
+        case 0:  return simulate_bounce(v, t, coefs);
+        case 1:  return simulate_elastic(v, t, coefs);
+        case 2:  return simulate_bounce_spin(v, t, coefs);
+        case 3:  return simulate_elastic_overshoot(v, t, coefs);
+        case 4:  return simulate_multibounce(v, t, coefs);
+        case 5:  return simulate_wobble(v, t, coefs);
+    }
+    return 0.0;
+}
+
+// Block kernels: buf holds the phase of each sample on entry and the output on exit
+void simulate_bounce_block(t_physics_voice *v, double *buf, long n, const t_physics_coefs *coefs);
+void simulate_elastic_block(t_physics_voice *v, double *buf, long n, const t_physics_coefs *coefs);
+void simulate_bounce_spin_block(t_physics_voice *v, double *buf, long n, const t_physics_coefs *coefs);
+void simulate_elastic_overshoot_block(t_physics_voice *v, double *buf, long n, const t_physics_coefs *coefs);
+void simulate_multibounce_block(t_physics_voice *v, double *buf, long n, const t_physics_coefs *coefs);
+void simulate_wobble_block(t_physics_voice *v, double *buf, long n, const t_physics_coefs *coefs);
+void render_physics_block(t_physics_voice *v, long type, double *buf, long n, const t_physics_coefs *coefs);
+
+// Single-precision kernels: float32 phases in, float32 values out; the render_
+// entry point takes double buffers and narrows/widens them per chunk
+void simulate_bounce_single(t_physics_voice *v, float *buf, long n, const t_physics_coefs *coefs);
+void simulate_elastic_single(t_physics_voice *v, float *buf, long n, const t_physics_coefs *coefs);
+void simulate_bounce_spin_single(t_physics_voice *v, float *buf, long n, const t_physics_coefs *coefs);
+void simulate_elastic_overshoot_single(t_physics_voice *v, float *buf, long n, const t_physics_coefs *coefs);
+void simulate_multibounce_single(t_physics_voice *v, float *buf, long n, const t_physics_coefs *coefs);
+void simulate_wobble_single(t_physics_voice *v, float *buf, long n, const t_physics_coefs *coefs);
+void render_physics_block_single(t_physics_voice *v, long type, double *buf, long n, const t_physics_coefs *coefs);
+
+// Recursive engine: same contract as the block kernels, dt is the constant phase increment
+void simulate_elastic_recursive(t_physics_voice *v, double *buf, long n, const t_physics_coefs *coefs, double dt);
+void simulate_bounce_spin_recursive(t_physics_voice *v, double *buf, long n, const t_physics_coefs *coefs, double dt);
+void simulate_elastic_overshoot_recursive(t_physics_voice *v, double *buf, long n, const t_physics_coefs *coefs, double dt);
+void simulate_wobble_recursive(t_physics_voice *v, double *buf, long n, const t_physics_coefs *coefs, double dt);
+void render_physics_recursive(t_physics_voice *v, long type, double *buf, long n, const t_physics_coefs *coefs, double dt);
+
+// Decimated rendering: same contract as the block kernels, with the curve evaluated
+// every factor samples and linear (or Catmull-Rom) interpolation in between
+double physics_fastest_rate(long type, const t_physics_coefs *coefs);
+void physics_decimated_render(t_physics_voice *v, long type, double *buf, long n, const t_physics_coefs *coefs,
+                              long factor, int cubic);
+
+// Half-band decimation: one 2:1 stage of a linear-phase FIR with taps coefficient
+// pairs around a center of 0.5, delaying by taps output samples. decimate
+// filters n (even) samples of buf in place into its first n / 2, carrying the
+// last PHYSICS_HALFBAND_HISTORY(taps) inputs in history; work holds
+// PHYSICS_HALFBAND_HISTORY(taps) + n doubles.
+#define PHYSICS_HALFBAND_MAX_TAPS 12
+#define PHYSICS_HALFBAND_HISTORY(taps) (4 * (taps) - 2)
+
+void physics_halfband_design(double *coefs, long taps);
+void physics_halfband_decimate(const double *coefs, long taps, double *history, double *buf, long n, double *work);
+
+// Block render API
+#define PHYSICS_RENDER_RECURSIVE    1   // Phasor/decay recurrences (@engine recursive)
+#define PHYSICS_RENDER_SINGLE       2   // Float32 curve evaluation (@precision single)
+
+void physics_voice_render(t_physics_voice *v, long type, double *out, long n, double param, double damping,
+                          double inc, long looping, int flags);
+void physics_cycle_render(long type, double param, double damping, double *data, long size, long oversample);
+
+//----------------------------------------------------------------------------------------------
+// Shared Loop Helpers
+//----------------------------------------------------------------------------------------------
+
+// Rising edge on the trigger inlet: the previous sample was <= 0 and this one is
+// > 0. Returns how much of this sample period has elapsed since the signal
+// crossed zero (linear interpolation, in (0, 1]), or 0 when there is no edge.
+// A 0 -> 1 step counts as a full sample, which matches what bang does.
+PHYSICSLFO_INLINE double physicslfo_trigger_edge(t_physics_voice *v, double trigger) {
+    double prev = v->trigger_prev;
+    
+    v->trigger_prev = trigger;
+    if (prev <= 0.0 && trigger > 0.0) {
+        return trigger / (trigger - prev);
+    }
+    return 0.0;
+}
+
+// Fixed-point phase (@accum fixed): 24.40 cycles in an unsigned 64-bit counter.
+// Every increment is rounded to 2^-40 of a cycle once (about 2 ppm of rate at
+// 0.01 Hz), then added exactly, so looping wraps never pick up rounding and a
+// long-running envelope keeps the resolution of its first cycle; a double phase
+// is coarser than that from 4096 cycles on. Instead of wrapping, the envelope
+// counter saturates at PHYSICS_PHASE_LIMIT (2^23 cycles, 2.3 hours at 1 kHz).
+#define PHYSICS_PHASE_FRAC_BITS 40
+#define PHYSICS_PHASE_ONE 1099511627776.0       // 2^PHYSICS_PHASE_FRAC_BITS
+#define PHYSICS_PHASE_FRAC_MASK 0xFFFFFFFFFFull
+#define PHYSICS_PHASE_LIMIT (1ull << 63)
+
+PHYSICSLFO_INLINE uint64_t physics_phase_to_fixed(double phase) {
+    if (!(phase > 0.0)) return 0;
+    if (phase >= PHYSICS_PHASE_LIMIT / PHYSICS_PHASE_ONE) return PHYSICS_PHASE_LIMIT;
+    return (uint64_t)(phase * PHYSICS_PHASE_ONE + 0.5);
+}
+
+PHYSICSLFO_INLINE double physics_phase_from_fixed(uint64_t fixed) {
+    return (double)fixed * (1.0 / PHYSICS_PHASE_ONE);
+}
+
+// Increment as the fixed-point counter actually advances, for callers that
+// need the constant dt (recursive engine)
+PHYSICSLFO_INLINE double physics_phase_increment(const t_physics_voice *v, double inc) {
+    return v->phase_fixed_on ? physics_phase_from_fixed(physics_phase_to_fixed(inc)) : inc;
+}
+
+// Phase writes from outside the render loop (bang, phase message, triggers)
+PHYSICSLFO_INLINE void physics_voice_set_phase(t_physics_voice *v, double phase) {
+    if (v->phase_fixed_on) {
+        v->phase_fixed = physics_phase_to_fixed(phase);
+        phase = physics_phase_from_fixed(v->phase_fixed);
+    }
+    v->phase = phase;
+}
+
+// Switch a voice between the double and fixed-point phase; the counter starts
+// from the phase the voice has now
+PHYSICSLFO_INLINE void physics_voice_phase_fixed(t_physics_voice *v, long on) {
+    if (on != v->phase_fixed_on) {
+        v->phase_fixed_on = on;
+        physics_voice_set_phase(v, v->phase);
+    }
+}
+
+// Fixed-point counterpart of the += / wrap in physicslfo_advance_phase. The
+// wrap masks off whole cycles, and the envelope counter saturates.
+PHYSICSLFO_INLINE int physicslfo_advance_phase_fixed(t_physics_voice *v, long looping, double *phase, double inc) {
+    uint64_t step = physics_phase_to_fixed(inc);
+    int wrapped = 0;
+    
+    if (looping) {
+        v->phase_fixed += step;
+        if (v->phase_fixed >> PHYSICS_PHASE_FRAC_BITS) {
+            v->phase_fixed &= PHYSICS_PHASE_FRAC_MASK;
+            wrapped = 1;
+        }
+    } else {
+        v->phase_fixed = v->phase_fixed < PHYSICS_PHASE_LIMIT - step ? v->phase_fixed + step : PHYSICS_PHASE_LIMIT;
+        if (v->envelope_active && (v->phase_fixed >> PHYSICS_PHASE_FRAC_BITS)) {
+            v->envelope_active = 0;
+        }
+    }
+    *phase = physics_phase_from_fixed(v->phase_fixed);
+    
+    return wrapped;
+}
+
+// Phase update shared by every perform routine: looping wraps (returns 1 so the
+// caller can reset the physics state), envelope mode lets the phase run on past
+// the first cycle. A trigger edge (elapsed > 0) restarts the cycle at the exact
+// sample, offset by the part of the sample that passed since the edge, and also
+// returns 1.
+PHYSICSLFO_INLINE int physicslfo_advance_phase(t_physics_voice *v, long looping, double *phase, double inc,
+                                               double elapsed) {
+    int wrapped = 0;
+    
+    if (elapsed > 0.0) {
+        *phase = elapsed * inc;
+        if (v->phase_fixed_on) {
+            v->phase_fixed = physics_phase_to_fixed(*phase);
+            *phase = physics_phase_from_fixed(v->phase_fixed);
+        }
+        if (!looping) v->envelope_active = 1;  // Start envelope
+        return 1;
+    }
+    
+    if (v->phase_fixed_on) {
+        return physicslfo_advance_phase_fixed(v, looping, phase, inc);
+    }
+    
+    *phase += inc;
+    
+    if (looping) {
+        // Wrap phase when cycle completes
+        if (*phase >= 1.0) {
+            *phase -= 1.0;
+            wrapped = 1;
+        }
+        while (*phase < 0.0) *phase += 1.0;
+    } else if (v->envelope_active && *phase >= 1.0) {
+        // Mark first cycle as complete but keep going - let natural decay occur
+        v->envelope_active = 0;
+    }
+    
+    return wrapped;
+}
+
+// Wavetable playback: linear interpolation into a cycle of size points, with
+// data[size] repeating data[0]. A phase can sit past 1.0 for a while after
+// leaving envelope mode; that reads the end of the cycle.
+PHYSICSLFO_INLINE double physics_table_read(const double *data, long size, double phase) {
+    double position = phase < 1.0 ? phase * (double)size : (double)size;
+    long index = (long)position;
+    
+    if (index > size - 1) index = size - 1;
+    return data[index] + (position - index) * (data[index + 1] - data[index]);
+}
+
+// Render one wrap-free segment of phases in place with the active engine. The
+// recursive engine keeps its double recurrences; single only picks the float32
+// closed-form kernels.
+PHYSICSLFO_INLINE void physicslfo_render_segment(t_physics_voice *v, long type, double *buf, long n,
+                                                 const t_physics_coefs *coefs, double recursive_dt, int single) {
+    if (recursive_dt > 0.0) {
+        render_physics_recursive(v, type, buf, n, coefs, recursive_dt);
+    } else if (single) {
+        render_physics_block_single(v, type, buf, n, coefs);
+    } else {
+        render_physics_block(v, type, buf, n, coefs);
+    }
+}
+
+
+// Rebuild the per-cycle constants only when physics or damping actually moved
+PHYSICSLFO_INLINE void physics_coefs_update(t_physics_coefs *coefs, double param, double damping) {
+    if (param != coefs->param || damping != coefs->damping) {
+        physics_coefs_build(coefs, param, damping);
+    }
+}
+
+// A voice's constants for the given controls plus the offsets @jitter drew for
+// the current cycle (0 without jitter)
+PHYSICSLFO_INLINE void physics_voice_coefs(t_physics_voice *v, double param, double damping) {
+    v->param_base = param;
+    v->damping_base = damping;
+    physics_coefs_update(&v->coefs, CLAMP(param + v->param_offset, 0.0, 1.0),
+                         CLAMP(damping + v->damping_offset, 0.0, 1.0));
+}
+
+// Counter-based generator (SplitMix64 finalizer on key + n): value n of a
+// stream depends on nothing else, so a seed replays exactly
+PHYSICSLFO_INLINE uint64_t physics_random(uint64_t key, uint64_t n) {
+    uint64_t z = key + (n + 1) * 0x9E3779B97F4A7C15ULL;
+    
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Uniform in [0, 1) from the top 53 bits
+PHYSICSLFO_INLINE double physics_random_unit(uint64_t key, uint64_t n) {
+    return (double)(physics_random(key, n) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+#endif // PHYSICSLFO_CORE_H
@@ -0,0 +1,67 @@
+/**
+ * physicslfo_plugin.h - C ABI for user-defined physics types
+ *
+ * A plugin is a shared library (.dylib / .dll) exporting one function named
+ * PHYSICSLFO_PLUGIN_SYMBOL that returns a static t_physicslfo_plugin. Sending
+ * [plugin <path>( to any physicslfo~ registers it as the next free type after
+ * the six built-in ones (6, 7, ...) for every instance; the type inlet then
+ * selects it like any other type.
+ *
+ * The plugin renders whole segments in place, the same contract as the
+ * built-in block kernels: buf holds the phase t of every sample on entry (0 to
+ * 1 in looping mode, running on past 1 after an envelope's first cycle) and
+ * the output values on return. Segments never span a cycle wrap; reset is
+ * called before the first segment of each cycle. Both run on the audio thread,
+ * so they must not allocate, lock or block.
+ *
+ * Per-voice state is up to PHYSICSLFO_PLUGIN_STATE doubles owned by the host.
+ *
+ *   static void ramp_reset(double *state, double param, double damping) {
+ *       state[0] = 1.0;
+ *   }
+ *   static void ramp_render(double *state, double *buf, long n, double param, double damping) {
+ *       for (long i = 0; i < n; i++) buf[i] = pow(1.0 - buf[i], 1.0 + param * 4.0);
+ *   }
+ *   static const t_physicslfo_plugin ramp = {
+ *       PHYSICSLFO_PLUGIN_API, "ramp", 1, ramp_reset, ramp_render
+ *   };
+ *   PHYSICSLFO_PLUGIN_EXPORT const t_physicslfo_plugin *physicslfo_plugin(void) { return &ramp; }
+ */
+
+#ifndef PHYSICSLFO_PLUGIN_H
+#define PHYSICSLFO_PLUGIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PHYSICSLFO_PLUGIN_API 1                 // Bumped on any change to the structures below
+#define PHYSICSLFO_PLUGIN_STATE 16              // Doubles of per-voice state a plugin may use
+#define PHYSICSLFO_PLUGIN_SYMBOL "physicslfo_plugin"
+
+#if defined(_WIN32)
+#define PHYSICSLFO_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define PHYSICSLFO_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+typedef struct _physicslfo_plugin {
+    int api;                    // PHYSICSLFO_PLUGIN_API the plugin was built against
+    const char *name;           // Shown in the console and the info outlet
+    int state_size;             // Doubles of state used, 0 to PHYSICSLFO_PLUGIN_STATE
+    
+    // Start of a cycle (bang, trigger, wrap): set up the voice's state
+    void (*reset)(double *state, double param, double damping);
+    
+    // n samples in place, phases in, values out (nominally 0 to 1)
+    void (*render)(double *state, double *buf, long n, double param, double damping);
+} t_physicslfo_plugin;
+
+// Signature of the exported PHYSICSLFO_PLUGIN_SYMBOL function
+typedef const t_physicslfo_plugin *(*t_physicslfo_plugin_entry)(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PHYSICSLFO_PLUGIN_H
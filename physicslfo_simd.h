@@ -0,0 +1,508 @@
+/**
+ * physicslfo_simd.h - Vectorized double-precision math for the physicslfo~ block kernels
+ *
+ * A thin lane abstraction (vd) over AVX2, SSE2, NEON and plain scalar code,
+ * plus polynomial sin/exp/log/pow approximations written once on top of it.
+ *
+ * Backend selection (compile time):
+ *   AVX2 + FMA  - 4 lanes, when built with -mavx2 -mfma
+ *   SSE2        - 2 lanes, default for x86_64 slices of the universal binary
+ *   NEON        - 2 lanes, arm64 slice of the universal binary
+ *   scalar      - 1 lane, any other target or when PHYSICSLFO_NO_SIMD is defined
+ *
+ * Every backend also provides vf, the same operations on float32 lanes (twice
+ * the lane count), with single-precision vf_sin2pi/exp/log/pow_pos for
+ * @precision single (about 1e-7 relative).
+ *
+ * Accuracy (measured against libm over the argument ranges used by the kernels):
+ *   vd_sin2pi   |err| <= 2e-16 absolute after argument reduction in turns
+ *   vd_exp      |err| <= 2 ulp for x in [-708, 709], exactly 0 below -708
+ *   vd_log      |err| <= 2 ulp for normal positive x
+ *   vd_pow_pos  relative error <= 4e-16 * (1 + |y * log(x)|), 0 for x <= 0
+ *
+ * sin(2.0 * PI * f * t) in the scalar path rounds its argument to double
+ * before reduction, so it carries its own error of about |2 pi f t| * 1.1e-16.
+ * The kernels reduce f * t in turns instead; the two agree to within 1e-12 for
+ * t < 16 (every looping cycle and the first seconds of an envelope) and the
+ * difference grows linearly with t after that.
+ */
+
+#ifndef PHYSICSLFO_SIMD_H
+#define PHYSICSLFO_SIMD_H
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define VD_INLINE static inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define VD_INLINE static __forceinline
+#else
+#define VD_INLINE static inline
+#endif
+
+//----------------------------------------------------------------------------------------------
+// Lane abstraction
+//----------------------------------------------------------------------------------------------
+
+#if defined(PHYSICSLFO_NO_SIMD)
+
+#define VD_SCALAR_FALLBACK 1
+
+#elif defined(__AVX2__) && defined(__FMA__)
+
+#include <immintrin.h>
+#define VD_LANES 4
+#define VD_BACKEND "avx2"
+typedef __m256d vd;
+
+VD_INLINE vd vd_set1(double a) { return _mm256_set1_pd(a); }
+VD_INLINE vd vd_loadu(const double *p) { return _mm256_loadu_pd(p); }
+VD_INLINE void vd_storeu(double *p, vd a) { _mm256_storeu_pd(p, a); }
+VD_INLINE vd vd_add(vd a, vd b) { return _mm256_add_pd(a, b); }
+VD_INLINE vd vd_sub(vd a, vd b) { return _mm256_sub_pd(a, b); }
+VD_INLINE vd vd_mul(vd a, vd b) { return _mm256_mul_pd(a, b); }
+VD_INLINE vd vd_div(vd a, vd b) { return _mm256_div_pd(a, b); }
+VD_INLINE vd vd_fmadd(vd a, vd b, vd c) { return _mm256_fmadd_pd(a, b, c); }
+VD_INLINE vd vd_min(vd a, vd b) { return _mm256_min_pd(a, b); }
+VD_INLINE vd vd_max(vd a, vd b) { return _mm256_max_pd(a, b); }
+VD_INLINE vd vd_lt(vd a, vd b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+VD_INLINE vd vd_le(vd a, vd b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+VD_INLINE vd vd_gt(vd a, vd b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+VD_INLINE vd vd_ne(vd a, vd b) { return _mm256_cmp_pd(a, b, _CMP_NEQ_UQ); }
+VD_INLINE vd vd_and(vd a, vd b) { return _mm256_and_pd(a, b); }
+VD_INLINE vd vd_or(vd a, vd b) { return _mm256_or_pd(a, b); }
+VD_INLINE vd vd_xor(vd a, vd b) { return _mm256_xor_pd(a, b); }
+VD_INLINE vd vd_select(vd mask, vd a, vd b) { return _mm256_blendv_pd(b, a, mask); }
+VD_INLINE int vd_any(vd mask) { return _mm256_movemask_pd(mask) != 0; }
+VD_INLINE vd vd_shl_bits(vd a, int n) { return _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_castpd_si256(a), n)); }
+VD_INLINE vd vd_shr_bits(vd a, int n) { return _mm256_castsi256_pd(_mm256_srli_epi64(_mm256_castpd_si256(a), n)); }
+VD_INLINE vd vd_set1_bits(uint64_t b) { return _mm256_castsi256_pd(_mm256_set1_epi64x((long long)b)); }
+
+#elif defined(__SSE2__) || defined(_M_X64)
+
+#include <emmintrin.h>
+#define VD_LANES 2
+#define VD_BACKEND "sse2"
+typedef __m128d vd;
+
+VD_INLINE vd vd_set1(double a) { return _mm_set1_pd(a); }
+VD_INLINE vd vd_loadu(const double *p) { return _mm_loadu_pd(p); }
+VD_INLINE void vd_storeu(double *p, vd a) { _mm_storeu_pd(p, a); }
+VD_INLINE vd vd_add(vd a, vd b) { return _mm_add_pd(a, b); }
+VD_INLINE vd vd_sub(vd a, vd b) { return _mm_sub_pd(a, b); }
+VD_INLINE vd vd_mul(vd a, vd b) { return _mm_mul_pd(a, b); }
+VD_INLINE vd vd_div(vd a, vd b) { return _mm_div_pd(a, b); }
+VD_INLINE vd vd_fmadd(vd a, vd b, vd c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+VD_INLINE vd vd_min(vd a, vd b) { return _mm_min_pd(a, b); }
+VD_INLINE vd vd_max(vd a, vd b) { return _mm_max_pd(a, b); }
+VD_INLINE vd vd_lt(vd a, vd b) { return _mm_cmplt_pd(a, b); }
+VD_INLINE vd vd_le(vd a, vd b) { return _mm_cmple_pd(a, b); }
+VD_INLINE vd vd_gt(vd a, vd b) { return _mm_cmpgt_pd(a, b); }
+VD_INLINE vd vd_ne(vd a, vd b) { return _mm_cmpneq_pd(a, b); }
+VD_INLINE vd vd_and(vd a, vd b) { return _mm_and_pd(a, b); }
+VD_INLINE vd vd_or(vd a, vd b) { return _mm_or_pd(a, b); }
+VD_INLINE vd vd_xor(vd a, vd b) { return _mm_xor_pd(a, b); }
+VD_INLINE vd vd_select(vd mask, vd a, vd b) { return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b)); }
+VD_INLINE int vd_any(vd mask) { return _mm_movemask_pd(mask) != 0; }
+VD_INLINE vd vd_shl_bits(vd a, int n) { return _mm_castsi128_pd(_mm_slli_epi64(_mm_castpd_si128(a), n)); }
+VD_INLINE vd vd_shr_bits(vd a, int n) { return _mm_castsi128_pd(_mm_srli_epi64(_mm_castpd_si128(a), n)); }
+VD_INLINE vd vd_set1_bits(uint64_t b) { return _mm_castsi128_pd(_mm_set1_epi64x((long long)b)); }
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+#include <arm_neon.h>
+#define VD_LANES 2
+#define VD_BACKEND "neon"
+typedef float64x2_t vd;
+
+VD_INLINE vd vd_set1(double a) { return vdupq_n_f64(a); }
+VD_INLINE vd vd_loadu(const double *p) { return vld1q_f64(p); }
+VD_INLINE void vd_storeu(double *p, vd a) { vst1q_f64(p, a); }
+VD_INLINE vd vd_add(vd a, vd b) { return vaddq_f64(a, b); }
+VD_INLINE vd vd_sub(vd a, vd b) { return vsubq_f64(a, b); }
+VD_INLINE vd vd_mul(vd a, vd b) { return vmulq_f64(a, b); }
+VD_INLINE vd vd_div(vd a, vd b) { return vdivq_f64(a, b); }
+VD_INLINE vd vd_fmadd(vd a, vd b, vd c) { return vfmaq_f64(c, a, b); }
+VD_INLINE vd vd_min(vd a, vd b) { return vminq_f64(a, b); }
+VD_INLINE vd vd_max(vd a, vd b) { return vmaxq_f64(a, b); }
+VD_INLINE vd vd_lt(vd a, vd b) { return vreinterpretq_f64_u64(vcltq_f64(a, b)); }
+VD_INLINE vd vd_le(vd a, vd b) { return vreinterpretq_f64_u64(vcleq_f64(a, b)); }
+VD_INLINE vd vd_gt(vd a, vd b) { return vreinterpretq_f64_u64(vcgtq_f64(a, b)); }
+VD_INLINE vd vd_ne(vd a, vd b) { return vreinterpretq_f64_u32(vmvnq_u32(vreinterpretq_u32_u64(vceqq_f64(a, b)))); }
+VD_INLINE vd vd_and(vd a, vd b) { return vreinterpretq_f64_u64(vandq_u64(vreinterpretq_u64_f64(a), vreinterpretq_u64_f64(b))); }
+VD_INLINE vd vd_or(vd a, vd b) { return vreinterpretq_f64_u64(vorrq_u64(vreinterpretq_u64_f64(a), vreinterpretq_u64_f64(b))); }
+VD_INLINE vd vd_xor(vd a, vd b) { return vreinterpretq_f64_u64(veorq_u64(vreinterpretq_u64_f64(a), vreinterpretq_u64_f64(b))); }
+VD_INLINE vd vd_select(vd mask, vd a, vd b) { return vbslq_f64(vreinterpretq_u64_f64(mask), a, b); }
+VD_INLINE int vd_any(vd mask) { return vmaxvq_u32(vreinterpretq_u32_f64(mask)) != 0; }
+VD_INLINE vd vd_shl_bits(vd a, int n) { return vreinterpretq_f64_u64(vshlq_u64(vreinterpretq_u64_f64(a), vdupq_n_s64(n))); }
+VD_INLINE vd vd_shr_bits(vd a, int n) { return vreinterpretq_f64_u64(vshlq_u64(vreinterpretq_u64_f64(a), vdupq_n_s64(-n))); }
+VD_INLINE vd vd_set1_bits(uint64_t b) { return vreinterpretq_f64_u64(vdupq_n_u64(b)); }
+
+#else
+
+#define VD_SCALAR_FALLBACK 1
+
+#endif
+
+#if defined(VD_SCALAR_FALLBACK)
+
+#define VD_LANES 1
+#define VD_BACKEND "scalar"
+typedef double vd;
+
+VD_INLINE uint64_t vd_bits_(double a) { uint64_t b; memcpy(&b, &a, sizeof b); return b; }
+VD_INLINE double vd_from_bits_(uint64_t b) { double a; memcpy(&a, &b, sizeof a); return a; }
+VD_INLINE vd vd_set1(double a) { return a; }
+VD_INLINE vd vd_loadu(const double *p) { return *p; }
+VD_INLINE void vd_storeu(double *p, vd a) { *p = a; }
+VD_INLINE vd vd_add(vd a, vd b) { return a + b; }
+VD_INLINE vd vd_sub(vd a, vd b) { return a - b; }
+VD_INLINE vd vd_mul(vd a, vd b) { return a * b; }
+VD_INLINE vd vd_div(vd a, vd b) { return a / b; }
+VD_INLINE vd vd_fmadd(vd a, vd b, vd c) { return a * b + c; }
+VD_INLINE vd vd_min(vd a, vd b) { return a < b ? a : b; }
+VD_INLINE vd vd_max(vd a, vd b) { return a > b ? a : b; }
+VD_INLINE vd vd_lt(vd a, vd b) { return vd_from_bits_(a < b ? ~0ULL : 0ULL); }
+VD_INLINE vd vd_le(vd a, vd b) { return vd_from_bits_(a <= b ? ~0ULL : 0ULL); }
+VD_INLINE vd vd_gt(vd a, vd b) { return vd_from_bits_(a > b ? ~0ULL : 0ULL); }
+VD_INLINE vd vd_ne(vd a, vd b) { return vd_from_bits_(a != b ? ~0ULL : 0ULL); }
+VD_INLINE vd vd_and(vd a, vd b) { return vd_from_bits_(vd_bits_(a) & vd_bits_(b)); }
+VD_INLINE vd vd_or(vd a, vd b) { return vd_from_bits_(vd_bits_(a) | vd_bits_(b)); }
+VD_INLINE vd vd_xor(vd a, vd b) { return vd_from_bits_(vd_bits_(a) ^ vd_bits_(b)); }
+VD_INLINE vd vd_select(vd mask, vd a, vd b) { return vd_bits_(mask) ? a : b; }
+VD_INLINE int vd_any(vd mask) { return vd_bits_(mask) != 0; }
+VD_INLINE vd vd_shl_bits(vd a, int n) { return vd_from_bits_(vd_bits_(a) << n); }
+VD_INLINE vd vd_shr_bits(vd a, int n) { return vd_from_bits_(vd_bits_(a) >> n); }
+VD_INLINE vd vd_set1_bits(uint64_t b) { return vd_from_bits_(b); }
+
+#endif
+
+//----------------------------------------------------------------------------------------------
+// Polynomial approximations
+//----------------------------------------------------------------------------------------------
+
+// 1.5 * 2^52: adding and subtracting rounds to the nearest integer for |x| < 2^51,
+// and the low mantissa bits of the intermediate hold that integer in two's complement
+#define VD_ROUND_MAGIC 6755399441055744.0
+
+VD_INLINE vd vd_rint(vd x) {
+    vd magic = vd_set1(VD_ROUND_MAGIC);
+    return vd_sub(vd_add(x, magic), magic);
+}
+
+VD_INLINE vd vd_floor(vd x) {
+    vd r = vd_rint(x);
+    return vd_sub(r, vd_and(vd_gt(r, x), vd_set1(1.0)));
+}
+
+// sin(2 * pi * x): reduce in turns to a quadrant, then a minimax pair on [-pi/4, pi/4]
+VD_INLINE vd vd_sin2pi(vd x) {
+    vd magic = vd_set1(VD_ROUND_MAGIC);
+    vd u = vd_mul(x, vd_set1(4.0));
+    vd q_biased = vd_add(u, magic);
+    vd q = vd_sub(q_biased, magic);
+    vd y = vd_mul(vd_sub(u, q), vd_set1(1.57079632679489661923));   // |y| <= pi/4
+    vd z = vd_mul(y, y);
+
+    vd s = vd_set1(1.58962301576546568060e-10);
+    s = vd_fmadd(s, z, vd_set1(-2.50507477628578072866e-8));
+    s = vd_fmadd(s, z, vd_set1(2.75573136213857245213e-6));
+    s = vd_fmadd(s, z, vd_set1(-1.98412698295895385996e-4));
+    s = vd_fmadd(s, z, vd_set1(8.33333333332211858878e-3));
+    s = vd_fmadd(s, z, vd_set1(-1.66666666666666307295e-1));
+    s = vd_fmadd(vd_mul(s, z), y, y);
+
+    vd c = vd_set1(-1.13585365213876817300e-11);
+    c = vd_fmadd(c, z, vd_set1(2.08757008419747316778e-9));
+    c = vd_fmadd(c, z, vd_set1(-2.75573141792967388112e-7));
+    c = vd_fmadd(c, z, vd_set1(2.48015872888517045348e-5));
+    c = vd_fmadd(c, z, vd_set1(-1.38888888888730564116e-3));
+    c = vd_fmadd(c, z, vd_set1(4.16666666666665929218e-2));
+    c = vd_fmadd(c, vd_mul(z, z), vd_fmadd(z, vd_set1(-0.5), vd_set1(1.0)));
+
+    // Odd quadrants use cosine, quadrants 2 and 3 flip the sign (bit 1 of q)
+    vd half_q = vd_mul(q, vd_set1(0.5));
+    vd odd = vd_ne(half_q, vd_rint(half_q));
+    vd sign = vd_and(vd_shl_bits(q_biased, 62), vd_set1_bits(0x8000000000000000ULL));
+    return vd_xor(vd_select(odd, c, s), sign);
+}
+
+// exp(x): n = round(x / ln2), degree-13 Taylor on |r| <= ln2 / 2, scale by 2^n
+VD_INLINE vd vd_exp(vd x) {
+    vd underflow = vd_lt(x, vd_set1(-708.0));
+    x = vd_min(vd_max(x, vd_set1(-708.0)), vd_set1(709.0));
+
+    vd n = vd_rint(vd_mul(x, vd_set1(1.44269504088896340736)));
+    vd r = vd_fmadd(n, vd_set1(-6.93145751953125e-1), x);
+    r = vd_fmadd(n, vd_set1(-1.42860682030941723212e-6), r);
+
+    vd p = vd_set1(1.0 / 6227020800.0);
+    p = vd_fmadd(p, r, vd_set1(1.0 / 479001600.0));
+    p = vd_fmadd(p, r, vd_set1(1.0 / 39916800.0));
+    p = vd_fmadd(p, r, vd_set1(1.0 / 3628800.0));
+    p = vd_fmadd(p, r, vd_set1(1.0 / 362880.0));
+    p = vd_fmadd(p, r, vd_set1(1.0 / 40320.0));
+    p = vd_fmadd(p, r, vd_set1(1.0 / 5040.0));
+    p = vd_fmadd(p, r, vd_set1(1.0 / 720.0));
+    p = vd_fmadd(p, r, vd_set1(1.0 / 120.0));
+    p = vd_fmadd(p, r, vd_set1(1.0 / 24.0));
+    p = vd_fmadd(p, r, vd_set1(1.0 / 6.0));
+    p = vd_fmadd(p, r, vd_set1(0.5));
+    p = vd_fmadd(p, r, vd_set1(1.0));
+    p = vd_fmadd(p, r, vd_set1(1.0));
+
+    // 2^n from the biased exponent: n + 1023 lands in the low mantissa bits of 2^52 + n + 1023
+    vd two_n = vd_shl_bits(vd_add(n, vd_set1(4503599627370496.0 + 1023.0)), 52);
+    return vd_select(underflow, vd_set1(0.0), vd_mul(p, two_n));
+}
+
+// log(x) for normal positive x: split exponent, atanh series in (m - 1) / (m + 1)
+VD_INLINE vd vd_log(vd x) {
+    vd e = vd_sub(vd_or(vd_shr_bits(x, 52), vd_set1_bits(0x4330000000000000ULL)), vd_set1(4503599627370496.0 + 1023.0));
+    vd m = vd_or(vd_and(x, vd_set1_bits(0x000fffffffffffffULL)), vd_set1_bits(0x3ff0000000000000ULL));
+
+    // Keep m in [sqrt(0.5), sqrt(2)) so the series converges quickly
+    vd big = vd_gt(m, vd_set1(1.41421356237309504880));
+    m = vd_select(big, vd_mul(m, vd_set1(0.5)), m);
+    e = vd_add(e, vd_and(big, vd_set1(1.0)));
+
+    vd z = vd_div(vd_sub(m, vd_set1(1.0)), vd_add(m, vd_set1(1.0)));
+    vd w = vd_mul(z, z);
+    vd p = vd_set1(1.0 / 21.0);
+    p = vd_fmadd(p, w, vd_set1(1.0 / 19.0));
+    p = vd_fmadd(p, w, vd_set1(1.0 / 17.0));
+    p = vd_fmadd(p, w, vd_set1(1.0 / 15.0));
+    p = vd_fmadd(p, w, vd_set1(1.0 / 13.0));
+    p = vd_fmadd(p, w, vd_set1(1.0 / 11.0));
+    p = vd_fmadd(p, w, vd_set1(1.0 / 9.0));
+    p = vd_fmadd(p, w, vd_set1(1.0 / 7.0));
+    p = vd_fmadd(p, w, vd_set1(1.0 / 5.0));
+    p = vd_fmadd(p, w, vd_set1(1.0 / 3.0));
+    p = vd_fmadd(p, w, vd_set1(1.0));
+    vd log_m = vd_mul(vd_add(z, z), p);
+
+    return vd_fmadd(e, vd_set1(6.93145751953125e-1), vd_fmadd(e, vd_set1(1.42860682030941723212e-6), log_m));
+}
+
+// pow(x, y) for y > 0, returning 0 for x <= 0 (and below the normal range)
+VD_INLINE vd vd_pow_pos(vd x, vd y) {
+    vd tiny = vd_lt(x, vd_set1(2.2250738585072014e-308));
+    vd safe = vd_max(x, vd_set1(2.2250738585072014e-308));
+    return vd_select(tiny, vd_set1(0.0), vd_exp(vd_mul(y, vd_log(safe))));
+}
+
+//----------------------------------------------------------------------------------------------
+// Single-precision lanes (@precision single)
+//----------------------------------------------------------------------------------------------
+// Same operation set as vd on float32, so a vector holds twice as many samples.
+// VF_LANES: AVX2 8, SSE2 4, NEON 4, scalar 1.
+
+#if defined(VD_SCALAR_FALLBACK)
+
+#define VF_LANES 1
+typedef float vf;
+
+VD_INLINE uint32_t vf_bits_(float a) { uint32_t b; memcpy(&b, &a, sizeof b); return b; }
+VD_INLINE float vf_from_bits_(uint32_t b) { float a; memcpy(&a, &b, sizeof a); return a; }
+VD_INLINE vf vf_set1(float a) { return a; }
+VD_INLINE vf vf_loadu(const float *p) { return *p; }
+VD_INLINE void vf_storeu(float *p, vf a) { *p = a; }
+VD_INLINE vf vf_add(vf a, vf b) { return a + b; }
+VD_INLINE vf vf_sub(vf a, vf b) { return a - b; }
+VD_INLINE vf vf_mul(vf a, vf b) { return a * b; }
+VD_INLINE vf vf_div(vf a, vf b) { return a / b; }
+VD_INLINE vf vf_fmadd(vf a, vf b, vf c) { return a * b + c; }
+VD_INLINE vf vf_min(vf a, vf b) { return a < b ? a : b; }
+VD_INLINE vf vf_max(vf a, vf b) { return a > b ? a : b; }
+VD_INLINE vf vf_lt(vf a, vf b) { return vf_from_bits_(a < b ? ~0U : 0U); }
+VD_INLINE vf vf_le(vf a, vf b) { return vf_from_bits_(a <= b ? ~0U : 0U); }
+VD_INLINE vf vf_gt(vf a, vf b) { return vf_from_bits_(a > b ? ~0U : 0U); }
+VD_INLINE vf vf_ne(vf a, vf b) { return vf_from_bits_(a != b ? ~0U : 0U); }
+VD_INLINE vf vf_and(vf a, vf b) { return vf_from_bits_(vf_bits_(a) & vf_bits_(b)); }
+VD_INLINE vf vf_or(vf a, vf b) { return vf_from_bits_(vf_bits_(a) | vf_bits_(b)); }
+VD_INLINE vf vf_xor(vf a, vf b) { return vf_from_bits_(vf_bits_(a) ^ vf_bits_(b)); }
+VD_INLINE vf vf_select(vf mask, vf a, vf b) { return vf_bits_(mask) ? a : b; }
+VD_INLINE int vf_any(vf mask) { return vf_bits_(mask) != 0; }
+VD_INLINE vf vf_shl_bits(vf a, int n) { return vf_from_bits_(vf_bits_(a) << n); }
+VD_INLINE vf vf_shr_bits(vf a, int n) { return vf_from_bits_(vf_bits_(a) >> n); }
+VD_INLINE vf vf_set1_bits(uint32_t b) { return vf_from_bits_(b); }
+
+#elif defined(__AVX2__) && defined(__FMA__)
+
+#define VF_LANES 8
+typedef __m256 vf;
+
+VD_INLINE vf vf_set1(float a) { return _mm256_set1_ps(a); }
+VD_INLINE vf vf_loadu(const float *p) { return _mm256_loadu_ps(p); }
+VD_INLINE void vf_storeu(float *p, vf a) { _mm256_storeu_ps(p, a); }
+VD_INLINE vf vf_add(vf a, vf b) { return _mm256_add_ps(a, b); }
+VD_INLINE vf vf_sub(vf a, vf b) { return _mm256_sub_ps(a, b); }
+VD_INLINE vf vf_mul(vf a, vf b) { return _mm256_mul_ps(a, b); }
+VD_INLINE vf vf_div(vf a, vf b) { return _mm256_div_ps(a, b); }
+VD_INLINE vf vf_fmadd(vf a, vf b, vf c) { return _mm256_fmadd_ps(a, b, c); }
+VD_INLINE vf vf_min(vf a, vf b) { return _mm256_min_ps(a, b); }
+VD_INLINE vf vf_max(vf a, vf b) { return _mm256_max_ps(a, b); }
+VD_INLINE vf vf_lt(vf a, vf b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+VD_INLINE vf vf_le(vf a, vf b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+VD_INLINE vf vf_gt(vf a, vf b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+VD_INLINE vf vf_ne(vf a, vf b) { return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ); }
+VD_INLINE vf vf_and(vf a, vf b) { return _mm256_and_ps(a, b); }
+VD_INLINE vf vf_or(vf a, vf b) { return _mm256_or_ps(a, b); }
+VD_INLINE vf vf_xor(vf a, vf b) { return _mm256_xor_ps(a, b); }
+VD_INLINE vf vf_select(vf mask, vf a, vf b) { return _mm256_blendv_ps(b, a, mask); }
+VD_INLINE int vf_any(vf mask) { return _mm256_movemask_ps(mask) != 0; }
+VD_INLINE vf vf_shl_bits(vf a, int n) { return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_castps_si256(a), n)); }
+VD_INLINE vf vf_shr_bits(vf a, int n) { return _mm256_castsi256_ps(_mm256_srli_epi32(_mm256_castps_si256(a), n)); }
+VD_INLINE vf vf_set1_bits(uint32_t b) { return _mm256_castsi256_ps(_mm256_set1_epi32((int)b)); }
+
+#elif defined(__SSE2__) || defined(_M_X64)
+
+#define VF_LANES 4
+typedef __m128 vf;
+
+VD_INLINE vf vf_set1(float a) { return _mm_set1_ps(a); }
+VD_INLINE vf vf_loadu(const float *p) { return _mm_loadu_ps(p); }
+VD_INLINE void vf_storeu(float *p, vf a) { _mm_storeu_ps(p, a); }
+VD_INLINE vf vf_add(vf a, vf b) { return _mm_add_ps(a, b); }
+VD_INLINE vf vf_sub(vf a, vf b) { return _mm_sub_ps(a, b); }
+VD_INLINE vf vf_mul(vf a, vf b) { return _mm_mul_ps(a, b); }
+VD_INLINE vf vf_div(vf a, vf b) { return _mm_div_ps(a, b); }
+VD_INLINE vf vf_fmadd(vf a, vf b, vf c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+VD_INLINE vf vf_min(vf a, vf b) { return _mm_min_ps(a, b); }
+VD_INLINE vf vf_max(vf a, vf b) { return _mm_max_ps(a, b); }
+VD_INLINE vf vf_lt(vf a, vf b) { return _mm_cmplt_ps(a, b); }
+VD_INLINE vf vf_le(vf a, vf b) { return _mm_cmple_ps(a, b); }
+VD_INLINE vf vf_gt(vf a, vf b) { return _mm_cmpgt_ps(a, b); }
+VD_INLINE vf vf_ne(vf a, vf b) { return _mm_cmpneq_ps(a, b); }
+VD_INLINE vf vf_and(vf a, vf b) { return _mm_and_ps(a, b); }
+VD_INLINE vf vf_or(vf a, vf b) { return _mm_or_ps(a, b); }
+VD_INLINE vf vf_xor(vf a, vf b) { return _mm_xor_ps(a, b); }
+VD_INLINE vf vf_select(vf mask, vf a, vf b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+VD_INLINE int vf_any(vf mask) { return _mm_movemask_ps(mask) != 0; }
+VD_INLINE vf vf_shl_bits(vf a, int n) { return _mm_castsi128_ps(_mm_slli_epi32(_mm_castps_si128(a), n)); }
+VD_INLINE vf vf_shr_bits(vf a, int n) { return _mm_castsi128_ps(_mm_srli_epi32(_mm_castps_si128(a), n)); }
+VD_INLINE vf vf_set1_bits(uint32_t b) { return _mm_castsi128_ps(_mm_set1_epi32((int)b)); }
+
+#else   // NEON
+
+#define VF_LANES 4
+typedef float32x4_t vf;
+
+VD_INLINE vf vf_set1(float a) { return vdupq_n_f32(a); }
+VD_INLINE vf vf_loadu(const float *p) { return vld1q_f32(p); }
+VD_INLINE void vf_storeu(float *p, vf a) { vst1q_f32(p, a); }
+VD_INLINE vf vf_add(vf a, vf b) { return vaddq_f32(a, b); }
+VD_INLINE vf vf_sub(vf a, vf b) { return vsubq_f32(a, b); }
+VD_INLINE vf vf_mul(vf a, vf b) { return vmulq_f32(a, b); }
+VD_INLINE vf vf_div(vf a, vf b) { return vdivq_f32(a, b); }
+VD_INLINE vf vf_fmadd(vf a, vf b, vf c) { return vfmaq_f32(c, a, b); }
+VD_INLINE vf vf_min(vf a, vf b) { return vminq_f32(a, b); }
+VD_INLINE vf vf_max(vf a, vf b) { return vmaxq_f32(a, b); }
+VD_INLINE vf vf_lt(vf a, vf b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+VD_INLINE vf vf_le(vf a, vf b) { return vreinterpretq_f32_u32(vcleq_f32(a, b)); }
+VD_INLINE vf vf_gt(vf a, vf b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+VD_INLINE vf vf_ne(vf a, vf b) { return vreinterpretq_f32_u32(vmvnq_u32(vceqq_f32(a, b))); }
+VD_INLINE vf vf_and(vf a, vf b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+VD_INLINE vf vf_or(vf a, vf b) { return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+VD_INLINE vf vf_xor(vf a, vf b) { return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+VD_INLINE vf vf_select(vf mask, vf a, vf b) { return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+VD_INLINE int vf_any(vf mask) { return vmaxvq_u32(vreinterpretq_u32_f32(mask)) != 0; }
+VD_INLINE vf vf_shl_bits(vf a, int n) { return vreinterpretq_f32_u32(vshlq_u32(vreinterpretq_u32_f32(a), vdupq_n_s32(n))); }
+VD_INLINE vf vf_shr_bits(vf a, int n) { return vreinterpretq_f32_u32(vshlq_u32(vreinterpretq_u32_f32(a), vdupq_n_s32(-n))); }
+VD_INLINE vf vf_set1_bits(uint32_t b) { return vreinterpretq_f32_u32(vdupq_n_u32(b)); }
+
+#endif
+
+// 1.5 * 2^23: the float counterpart of VD_ROUND_MAGIC, exact for |x| < 2^22
+#define VF_ROUND_MAGIC 12582912.0f
+
+VD_INLINE vf vf_rint(vf x) {
+    vf magic = vf_set1(VF_ROUND_MAGIC);
+    return vf_sub(vf_add(x, magic), magic);
+}
+
+VD_INLINE vf vf_floor(vf x) {
+    vf r = vf_rint(x);
+    return vf_sub(r, vf_and(vf_gt(r, x), vf_set1(1.0f)));
+}
+
+// sin(2 * pi * x), |err| <= 1e-7 after reduction: same quadrant scheme as vd_sin2pi
+VD_INLINE vf vf_sin2pi(vf x) {
+    vf magic = vf_set1(VF_ROUND_MAGIC);
+    vf u = vf_mul(x, vf_set1(4.0f));
+    vf q_biased = vf_add(u, magic);
+    vf q = vf_sub(q_biased, magic);
+    vf y = vf_mul(vf_sub(u, q), vf_set1(1.57079632679f));
+    vf z = vf_mul(y, y);
+    
+    vf s = vf_set1(-1.9515295891e-4f);
+    s = vf_fmadd(s, z, vf_set1(8.3321608736e-3f));
+    s = vf_fmadd(s, z, vf_set1(-1.6666654611e-1f));
+    s = vf_fmadd(vf_mul(s, z), y, y);
+    
+    vf c = vf_set1(2.443315711809948e-5f);
+    c = vf_fmadd(c, z, vf_set1(-1.388731625493765e-3f));
+    c = vf_fmadd(c, z, vf_set1(4.166664568298827e-2f));
+    c = vf_fmadd(c, vf_mul(z, z), vf_fmadd(z, vf_set1(-0.5f), vf_set1(1.0f)));
+    
+    vf half_q = vf_mul(q, vf_set1(0.5f));
+    vf odd = vf_ne(half_q, vf_rint(half_q));
+    vf sign = vf_and(vf_shl_bits(q_biased, 30), vf_set1_bits(0x80000000U));
+    return vf_xor(vf_select(odd, c, s), sign);
+}
+
+// exp(x), about 2 ulp for x in [-87, 88], exactly 0 below -87
+VD_INLINE vf vf_exp(vf x) {
+    vf underflow = vf_lt(x, vf_set1(-87.0f));
+    x = vf_min(vf_max(x, vf_set1(-87.0f)), vf_set1(88.0f));
+    
+    vf n = vf_rint(vf_mul(x, vf_set1(1.44269504089f)));
+    vf r = vf_fmadd(n, vf_set1(-0.693359375f), x);
+    r = vf_fmadd(n, vf_set1(2.12194440e-4f), r);
+    
+    vf p = vf_set1(1.9875691500e-4f);
+    p = vf_fmadd(p, r, vf_set1(1.3981999507e-3f));
+    p = vf_fmadd(p, r, vf_set1(8.3334519073e-3f));
+    p = vf_fmadd(p, r, vf_set1(4.1665795894e-2f));
+    p = vf_fmadd(p, r, vf_set1(1.6666665459e-1f));
+    p = vf_fmadd(p, r, vf_set1(5.0000001201e-1f));
+    p = vf_fmadd(vf_mul(p, r), r, vf_add(r, vf_set1(1.0f)));
+    
+    vf two_n = vf_shl_bits(vf_add(n, vf_set1(8388608.0f + 127.0f)), 23);
+    return vf_select(underflow, vf_set1(0.0f), vf_mul(p, two_n));
+}
+
+// log(x) for normal positive x, about 2 ulp
+VD_INLINE vf vf_log(vf x) {
+    vf e = vf_sub(vf_or(vf_shr_bits(x, 23), vf_set1_bits(0x4B000000U)), vf_set1(8388608.0f + 127.0f));
+    vf m = vf_or(vf_and(x, vf_set1_bits(0x007FFFFFU)), vf_set1_bits(0x3F800000U));
+    
+    vf big = vf_gt(m, vf_set1(1.41421356237f));
+    m = vf_select(big, vf_mul(m, vf_set1(0.5f)), m);
+    e = vf_add(e, vf_and(big, vf_set1(1.0f)));
+    
+    vf f = vf_sub(m, vf_set1(1.0f));
+    vf z = vf_mul(f, f);
+    vf p = vf_set1(7.0376836292e-2f);
+    p = vf_fmadd(p, f, vf_set1(-1.1514610310e-1f));
+    p = vf_fmadd(p, f, vf_set1(1.1676998740e-1f));
+    p = vf_fmadd(p, f, vf_set1(-1.2420140846e-1f));
+    p = vf_fmadd(p, f, vf_set1(1.4249322787e-1f));
+    p = vf_fmadd(p, f, vf_set1(-1.6668057665e-1f));
+    p = vf_fmadd(p, f, vf_set1(2.0000714765e-1f));
+    p = vf_fmadd(p, f, vf_set1(-2.4999993993e-1f));
+    p = vf_fmadd(p, f, vf_set1(3.3333331174e-1f));
+    p = vf_fmadd(vf_mul(p, f), z, vf_fmadd(z, vf_set1(-0.5f), f));
+    
+    return vf_fmadd(e, vf_set1(0.693359375f), vf_fmadd(e, vf_set1(-2.12194440e-4f), p));
+}
+
+// pow(x, y) for y > 0, returning 0 for x <= 0 (and below the normal range)
+VD_INLINE vf vf_pow_pos(vf x, vf y) {
+    vf tiny = vf_lt(x, vf_set1(1.17549435e-38f));
+    vf safe = vf_max(x, vf_set1(1.17549435e-38f));
+    return vf_select(tiny, vf_set1(0.0f), vf_exp(vf_mul(y, vf_log(safe))));
+}
+
+#endif // PHYSICSLFO_SIMD_H
@@ -14,17 +14,58 @@
  * 
  * Inlets:
  *   1. Frequency/Trigger (signal/float/bang) - Hz frequency or bang to reset/trigger
- *   2. LFO type (signal/float/int, 0-5) - physics simulation type
+ *   2. LFO type (signal/float/int, 0-5, plugins from 6) - physics simulation type
  *   3. Physics parameter (signal/float, 0.0-1.0) - bounce height/spring tension
  *   4. Damping (signal/float, 0.0-1.0) - energy loss rate
+ *   5. Trigger (signal) - rising edge resets/triggers at that exact sample
  * 
  * Messages:
  *   looping 1 - Enable looping mode (default) - continuous physics simulation
  *   looping 0 - Enable envelope mode - one-shot physics triggered by bang
  *   phase <float> - Set phase position (0.0-1.0) in looping mode
+ *   getstats - Send the @profile timing statistics out of the info outlet
+ *   voicebang <voice> - Reset/trigger one voice (1 to @chans)
+ *   getstate - Send the simulation state of every voice out of the info outlet
+ *   setstate <looping> <phase energy bounces velocity spin envelope>... - Continue from a saved state
+ *   render <buffer~> <seconds> - Bake the current curve into a buffer~ on a worker thread
+ *   plugin <path> - Load a physics type from a shared library (physicslfo_plugin.h)
+ * 
+ * Attributes:
+ *   @engine closed/recursive - Render engine for float-controlled instances
+ *   @precision double/single - Curve evaluation precision of the block kernels
+ *   @decimate <int> - Evaluate the curve every N samples and interpolate (1-64)
+ *   @interp linear/cubic - Interpolation between decimated evaluations
+ *   @accum double/fixed - Phase accumulator; fixed is a 64-bit counter that stops once an envelope settles
+ *   @quality exact/table - Per-sample physics or shared wavetable playback
+ *   @morph 0/1 - A fractional type signal blends the two adjacent types instead of switching
+ *   @audiorate 0/1 - Frequencies up to 20 kHz, with polyBLEP/polyBLAMP at wraps and cusps
+ *   @oversample 1/2/4/8 - Render fast curves at a multiple of the sample rate and decimate
+ *     (applies when the DSP chain is rebuilt, adds 12-15 samples of latency)
+ *   @tablesize <int> - Points per cycle in table mode (64-65536, default 1024)
+ *   @chans <int> - Independent voices on a multichannel outlet (creation only)
+ *   @taps <int> - Signal outlets reading one simulation at phase offsets (creation only)
+ *   @offsets <list> - Phase lag of each tap in cycles (default evenly spread)
+ *   @events 0/1 - Add an outlet with impulses at cycle starts and collisions (creation only)
+ *   @smooth <ms> - Ramp time for float frequency/physics/damping changes
+ *   @jitter <energy> [damping] [physics] - Random variation drawn once per cycle (0-1 each)
+ *   @seed <int> - Seed of the @jitter sequence; setting it restarts the sequence
+ *   @sync off/<note value> - Follow the transport with a period such as 4n, 8nd, 16nt or 1m instead of Hz
+ *   @transport <name> - Named transport for @sync (default: the global transport)
+ *   @verbose 0/1 - Post physics type info (deferred, rate limited)
+ *   @idle - Read only: 1 while every voice is settled (see outlet 2)
+ *   @profile 0/1 - Time every perform call (applies when the DSP chain is rebuilt)
  * 
  * Outlets:
  *   1. LFO output (signal, 0.0 to 1.0) - natural physics range
+ *   (With @events 1, an event signal outlet follows the LFO outlets: 1 at each new cycle,
+ *    0.5 at each ground contact, 0 otherwise)
+ *   2. Idle (int) - 1 once every voice's envelope has settled, 0 when active again
+ *   3. Info - stats <blocks> <min> <mean> <max> <p99> <load> in response to getstats,
+ *      render <buffer~> <seconds> when a render has been written, plugin <type> <name>,
+ *      state <looping> <phase energy bounces velocity spin envelope>... in response to getstate
+ * 
+ * The physics engine itself (simulate_*, block kernels, recursive engine) lives
+ * in physicslfo_core.c and has no Max dependency; this file is the Max glue.
  * 
  * LFO Types:
  *   0: Bounce - param: bounce curve (0=droopy/slow, 1=sharp/fast)
@@ -37,75 +78,449 @@
 
 #include "ext.h"
 #include "ext_obex.h"
+#include "ext_itm.h"
+#include "ext_buffer.h"
+#include "ext_systhread.h"
 #include "z_dsp.h"
 #include <math.h>
+#if defined(__APPLE__)
+#include <mach/mach_time.h>
+#elif !defined(_WIN32)
+#include <time.h>
+#endif
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+#include "physicslfo_core.h"
 
-#define PI 3.14159265358979323846
 #define MAX_BOUNCES 8
 
+// Wavetable mode (@quality table)
+#define PHYSICSLFO_TABLE_DEFAULT_SIZE 1024
+#define PHYSICSLFO_TABLE_MIN_SIZE 64
+#define PHYSICSLFO_TABLE_MAX_SIZE 65536
+#define PHYSICSLFO_TABLE_QUANT 1000     // Param/damping steps per unit in the cache key
+#define PHYSICSLFO_TABLE_OVERSAMPLE 4   // Sub-samples averaged into each table point
+#define PHYSICSLFO_TABLE_SPARES 8       // Unreferenced tables kept for reuse
+#define PHYSICSLFO_TABLE_POLL 10        // ms between checks for a finished or retirable table
+#define PHYSICSLFO_TABLE_RETIRED 4      // Replaced tables waiting for perform to move on
+
+// Control-rate rendering (@decimate)
+#define PHYSICSLFO_DECIMATE_MAX 64
+#define PHYSICSLFO_DECIMATE_MIN_POINTS 16   // Anchors per period of the fastest term, else full rate
+
+// Audio-rate mode (@audiorate); the LFO paths stop at PHYSICSLFO_FREQ_MAX
+#define PHYSICSLFO_FREQ_MAX 1000.0
+#define PHYSICSLFO_AUDIORATE_FREQ_MAX 20000.0   // Also capped at half the sample rate
+#define PHYSICSLFO_AUDIORATE_PROBE 1e-6         // Step in t of the one-sided slopes at a discontinuity
+
+// Oversampling (@oversample attribute)
+#define PHYSICSLFO_OVERSAMPLE_MAX 8             // Highest render rate multiple (three half-band stages)
+#define PHYSICSLFO_OVERSAMPLE_STAGES 3
+#define PHYSICSLFO_OVERSAMPLE_TAPS 12           // Coefficient pairs of the last stage, down to the sample rate
+#define PHYSICSLFO_OVERSAMPLE_TAPS_EARLY 4      // Earlier stages only guard the last one's stopband
+#define PHYSICSLFO_OVERSAMPLE_HARMONICS 8       // Harmonics of the fastest term that must fit below Nyquist
+#define PHYSICSLFO_OVERSAMPLE_RING 32           // Base-rate history per voice (power of two, > the latency)
+
+// Multichannel voices (@chans)
+#define PHYSICSLFO_MAX_VOICES 1024
+
+// Phase-offset taps (@taps); the voice array holds the shared phase plus one state per tap
+#define PHYSICSLFO_MAX_TAPS 64
+#define PHYSICSLFO_VOICE_COUNT(x) ((x)->taps > 1 ? (x)->taps + 1 : (x)->chans)
+#define PHYSICSLFO_SIGNAL_OUTLETS(x) (((x)->taps > 1 ? (x)->taps : 1) + (x)->events)
+
+// Event outlet impulses (@events)
+#define PHYSICSLFO_EVENT_WRAP 1.0       // New cycle: looping wrap, bang or trigger edge
+#define PHYSICSLFO_EVENT_COLLISION 0.5  // Ground contact of a bounce
+
+// Signal inlets: frequency, type, physics, damping, trigger
+#define PHYSICSLFO_NUM_INLETS 5
+
+// Message -> audio thread handoff
+#define PHYSICSLFO_QUEUE_SIZE 256       // Pending events (power of two)
+
+// Console logging (@verbose)
+#define PHYSICSLFO_LOG_INTERVAL 250     // Minimum ms between posts per instance
+
+// Transport sync (@sync)
+#define PHYSICSLFO_SYNC_TICKS_PER_WHOLE 1920.0  // Max transport resolution, 480 ticks per quarter note
+#define PHYSICSLFO_SYNC_JUMP 1e-6               // Phase mismatch (cycles) treated as a transport locate
+#define PHYSICSLFO_SYNC_RETIRE_POLL 20          // ms between checks for an unused transport reference
+#define PHYSICSLFO_SYNC_RETIRED 4               // Replaced transports waiting for perform to move on
+
+// Physics type registry: built-in types, then plugins (plugin message)
+#define PHYSICSLFO_MAX_TYPES 64
+
+// Offline rendering (render message)
+#define PHYSICSLFO_RENDER_BLOCK 4096            // Samples per core render call on the worker
+#define PHYSICSLFO_RENDER_MAX_SECONDS 600.0     // Longest render accepted
+
+// DSP profiling (@profile)
+#define PHYSICSLFO_PROFILE_OCTAVE 8     // Histogram bins per doubling of ns per block
+#define PHYSICSLFO_PROFILE_BINS 256     // From 1 ns up to 2^32 ns
+
+// Float parameters and mode as seen by the perform routine
+typedef struct _physicslfo_params {
+    double freq;                // Frequency when no signal connected
+    double type;                // LFO type when no signal connected
+    double physics;             // Physics parameter when no signal connected
+    double damping;             // Damping when no signal connected
+    long looping;               // 1 = looping, 0 = envelope mode
+    double smooth;              // Ramp time for float changes in ms (@smooth)
+    double sync_notes;          // @sync period in ticks for note values, 0 for bars or off
+    double sync_bars;           // @sync period in bars (follows the time signature), 0 for notes or off
+    double tap_offsets[PHYSICSLFO_MAX_TAPS];   // @offsets, phase lag of each tap in cycles
+    double jitter[PHYSICS_JITTER_AMOUNTS];     // @jitter amounts
+    long jitter_seed;           // @seed
+    unsigned long jitter_epoch; // Bumped by every @seed, restarts the voices' streams
+} t_physicslfo_params;
+
+// Linear ramp toward the latest float value (@smooth), advanced once per block
+typedef struct _physicslfo_ramp {
+    double value;               // Smoothed value at block start
+    double target;              // Value being approached
+    double step;                // Change per sample
+    long remaining;             // Samples left until target is reached
+} t_physicslfo_ramp;
+
+// Discrete events queued by message handlers for the audio thread
+enum {
+    PHYSICSLFO_CMD_TRIGGER,         // bang / voicebang
+    PHYSICSLFO_CMD_PHASE,           // phase <float>
+    PHYSICSLFO_CMD_STOP_ENVELOPE,   // looping 0 stops running envelopes
+    PHYSICSLFO_CMD_SETSTATE,        // setstate: load every voice from state_in
+    PHYSICSLFO_CMD_GETSTATE         // getstate: snapshot every voice into state_out
+};
+
+typedef struct _physicslfo_command {
+    long type;                  // PHYSICSLFO_CMD_*
+    long voice;                 // Target voice index, or -1 for every voice
+    long envelope;              // TRIGGER: 1 if sent in envelope mode
+    double value;               // PHASE: new phase position
+} t_physicslfo_command;
+
+// Per-block timing gathered by the profiling perform routine
+typedef struct _physicslfo_stats {
+    unsigned long blocks;           // Timed perform calls
+    double total_ns;                // Time spent in perform
+    double audio_ns;                // Audio time those blocks cover
+    double min_ns;
+    double max_ns;
+    unsigned long histogram[PHYSICSLFO_PROFILE_BINS];
+} t_physicslfo_stats;
+
+// An offline render: the controls it was started with and the worker's output.
+// Everything but cancel is written before the worker starts and read after it
+// has been joined.
+typedef struct _physicslfo_render {
+    t_symbol *buffer;               // Destination buffer~
+    double seconds;                 // Requested length
+    long frames;                    // Samples to render
+    long type;                      // Physics type 0-5
+    double physics;                 // Physics parameter
+    double damping;                 // Damping
+    double inc;                     // Phase increment per sample
+    long looping;                   // 1 = looping, 0 = one envelope from a trigger
+    long fixed;                     // @accum fixed
+    double jitter[PHYSICS_JITTER_AMOUNTS];  // @jitter, replayed from the start of the @seed sequence
+    long seed;                      // @seed
+    int flags;                      // PHYSICS_RENDER_* for @engine and @precision
+    float *data;                    // frames samples written by the worker
+    volatile long cancel;           // Set by free to stop the worker early
+} t_physicslfo_render;
+
+// One physics type; plugins are loaded once and never unloaded, so an entry
+// stays valid for perform as soon as it is counted
+typedef struct _physicslfo_type {
+    const char *name;                   // Console and info outlet name
+    const t_physicslfo_plugin *plugin;  // NULL for the built-in types (block kernels)
+} t_physicslfo_type;
+
+// @oversample state of one voice: decimator histories, and the base-rate
+// output and events of the recent blocks. Blocks that skip oversampling are
+// delayed through the rings by the decimator's latency, and a voice that
+// resumes oversampling refills the histories from them.
+typedef struct _physicslfo_oversampler {
+    double history[PHYSICSLFO_OVERSAMPLE_STAGES][PHYSICS_HALFBAND_HISTORY(PHYSICSLFO_OVERSAMPLE_TAPS)];
+    double ring[PHYSICSLFO_OVERSAMPLE_RING];        // Undelayed output, one value per base sample
+    double event_ring[PHYSICSLFO_OVERSAMPLE_RING];  // Undelayed events
+    unsigned long ring_pos;     // Base samples written so far
+    long active;                // 1 when the last block was oversampled
+} t_physicslfo_oversampler;
+
+// One rendered looping cycle, shared by every instance with the same key
+typedef struct _physics_table {
+    long type;                      // Physics type 0-5
+    long param_step;                // Physics parameter * PHYSICSLFO_TABLE_QUANT
+    long damping_step;              // Damping * PHYSICSLFO_TABLE_QUANT
+    long size;                      // Number of points in one cycle
+    long refcount;                  // Instances playing or waiting for this table
+    unsigned long released;         // Release stamp, orders spares for eviction
+    volatile long ready;            // 1 once the worker has rendered data
+    long rendering;                 // 1 while the worker renders it (cache lock)
+    double *data;                   // size + 1 points (last is the end of the cycle)
+    struct _physics_table *next;
+} t_physics_table;
+
 typedef struct _physicslfo {
     t_pxobject ob;              // MSP object header
     
     // Core oscillator state
-    double phase;               // Current phase (0.0 to 1.0)
     double sr;                  // Sample rate
     double sr_inv;              // 1.0 / sample rate
     
-    // Parameter storage (lores~ pattern)
+    // Parameter storage (lores~ pattern), owned by the message thread
     double freq_float;          // Frequency when no signal connected
     double type_float;          // LFO type when no signal connected
     double physics_float;       // Physics parameter when no signal connected
     double damping_float;       // Damping when no signal connected
     
+    // Message -> audio handoff (see Message Thread Handoff)
+    t_critical message_lock;            // Serializes producers, never taken by perform
+    t_physicslfo_params params;         // Audio-thread copy of the float parameters
+    t_physicslfo_params pending;        // Latest values published by the message thread
+    volatile unsigned long pending_seq; // Odd while pending is being written
+    unsigned long params_seq;           // Sequence of the snapshot in params
+    t_physicslfo_command queue[PHYSICSLFO_QUEUE_SIZE];
+    volatile unsigned long queue_write; // Advanced by the message thread only
+    volatile unsigned long queue_read;  // Advanced by the audio thread only
+    
+    // Parameter smoothing (@smooth attribute)
+    double smooth_ms;                   // Ramp time for float changes, 0 = jump
+    t_physicslfo_ramp ramp_freq;        // Audio thread only, like params
+    t_physicslfo_ramp ramp_physics;
+    t_physicslfo_ramp ramp_damping;
+    
+    // Per-cycle variation (@jitter and @seed attributes)
+    double jitter[PHYSICS_JITTER_AMOUNTS];  // Energy, damping and physics amounts
+    long jitter_count;                  // Amounts given to @jitter
+    long seed;                          // Seed of the sequence
+    unsigned long jitter_epoch;         // Times @seed was set
+    
+    // Console logging (@verbose attribute)
+    long verbose;                       // 1 = post physics type info on type changes
+    void *log_clock;                    // Delays a post until the rate limit allows it
+    long log_type;                      // Latest type to report
+    long log_pending;                   // 1 while a post is scheduled
+    unsigned long log_last;             // systime_ms() of the last post
+    
+    // Settled envelopes (@idle attribute and idle outlet)
+    long idle;                          // 1 while every voice is settled, written by perform
+    void *idle_clock;                   // Reports idle changes from the scheduler
+    void *idle_outlet;                  // Int outlet right of the signal outlet
+    
+    // Transport sync (@sync and @transport attributes)
+    t_symbol *sync;                     // off (default) or a note value (4n, 8nd, 16nt, 1m, ...)
+    double sync_notes;                  // Period in ticks for note values, 0 for bars (message thread)
+    double sync_bars;                   // Period in bars, 0 for notes (message thread)
+    t_symbol *transport;                // Transport name, empty = global transport
+    t_itm *volatile sync_itm;           // Referenced transport read by perform, NULL = sync off
+    volatile unsigned long sync_reads;  // Bumped once per block, after reading sync_itm and before x->table
+    t_itm *sync_retired[PHYSICSLFO_SYNC_RETIRED];      // Replaced transports, still referenced
+    unsigned long sync_retired_at[PHYSICSLFO_SYNC_RETIRED]; // sync_reads when each was replaced
+    void *sync_clock;                   // Polls until the replaced transports can be dereferenced
+    long sync_active;                   // Audio thread: 1 while this block follows the transport
+    double sync_phase;                  // Audio thread: transport phase of the block's first sample
+    
+    // Voice handoff (getstate/setstate messages)
+    t_physics_voice_state *state_in;    // setstate records, one per voice
+    volatile long state_in_pending;     // 1 until the audio thread has loaded state_in
+    t_physics_voice_state *state_out;   // getstate snapshot taken at a block boundary
+    long state_out_looping;             // Looping mode at the snapshot
+    volatile unsigned long state_out_seq;   // Odd while the audio thread writes state_out
+    void *state_clock;                  // Sends the snapshot from the scheduler
+    
+    // DSP profiling (@profile attribute, getstats message)
+    long profile;                       // 1 = dsp64 registers the timed perform wrapper
+    t_physicslfo_stats stats;           // Written by the audio thread only
+    volatile unsigned long stats_seq;   // Odd while the audio thread updates stats
+    volatile unsigned long stats_reset; // Bumped by the message thread to clear stats
+    unsigned long stats_reset_done;     // Last reset applied by the audio thread
+    void *info_outlet;                  // Rightmost outlet, getstats replies
+    
+    // Offline rendering (render message)
+    t_systhread render_thread;          // Worker of the running render, NULL when idle
+    t_physicslfo_render render;         // Controls and output of the running render
+    void *render_qelem;                 // Copies a finished render into its buffer~ (main thread)
+    
     // Signal connection status (lores~ pattern)
     short freq_has_signal;      // 1 if frequency inlet has signal connection
     short type_has_signal;      // 1 if type inlet has signal connection
     short physics_has_signal;   // 1 if physics inlet has signal connection
     short damping_has_signal;   // 1 if damping inlet has signal connection
+    short trigger_has_signal;   // 1 if trigger inlet has signal connection
+    
+    // Voices (@chans attribute)
+    long chans;                 // Number of independent voices / output channels
+    t_physics_voice *voices;    // chans voices, allocated at creation
+    long inlet_chans[PHYSICSLFO_NUM_INLETS];   // Channels arriving at each signal inlet
+    long inlet_offset[PHYSICSLFO_NUM_INLETS];  // Index of each inlet's first channel in the perform ins array
     
-    // Physics simulation state
-    double velocity;            // Current velocity
-    double acceleration;        // Current acceleration
-    double energy;              // Current energy level (0.0-1.0)
-    double bounce_count;        // Number of bounces occurred
-    double last_value;          // Previous output value
-    double spin_phase;          // Phase for spin calculations
+    // Phase-offset taps (@taps and @offsets attributes)
+    long taps;                  // Signal outlets, 1 = plain single output
+    double tap_offsets[PHYSICSLFO_MAX_TAPS];   // Lag of each tap in cycles (message thread)
+    long tap_offsets_count;     // Offsets set with @offsets, the rest are evenly spread
+    
+    // Event outlet (@events attribute)
+    long events;                // 1 = signal outlet of cycle and collision impulses
     
     // Mode control
-    long looping_mode;          // 1 = looping (default), 0 = envelope mode
-    long envelope_active;       // 1 when envelope is running, 0 when finished
+    long looping_mode;          // 1 = looping (default), 0 = envelope mode (message thread)
+    
+    // Render engine (@engine attribute)
+    t_symbol *engine;           // closed (default) or recursive
+    long engine_recursive;      // 1 = phasor/decay recurrences when inputs hold steady
+    
+    // Curve evaluation precision (@precision attribute)
+    t_symbol *precision;        // double (default) or single
+    long precision_single;      // 1 = float32 block kernels, phase stays double
+    
+    // Control-rate rendering (@decimate and @interp attributes)
+    long decimate;              // Evaluate every N samples, 1 = full rate
+    t_symbol *interp;           // linear (default) or cubic
+    long interp_cubic;          // 1 = Catmull-Rom between evaluations
+    
+    // Type morphing (@morph attribute)
+    long morph;                 // 1 = blend adjacent types for fractional type signals
+    
+    // Audio-rate mode (@audiorate attribute)
+    long audiorate;             // 1 = frequency up to 20 kHz with band-limited discontinuities
+    
+    // Oversampling (@oversample attribute), buffers allocated by dsp64
+    long oversample;            // Render rate multiple, 1 = off (applies when the DSP chain is rebuilt)
+    long os_factor;             // Multiple the buffers below were set up for, read by perform
+    long os_vectorsize;         // Largest block the buffers hold
+    long os_delay;              // Decimator latency in samples
+    double os_kernel[PHYSICSLFO_OVERSAMPLE_TAPS];             // Last stage
+    double os_kernel_early[PHYSICSLFO_OVERSAMPLE_TAPS_EARLY]; // Earlier stages
+    t_physicslfo_oversampler *os_state;     // One per voice
+    double *os_buffer;          // Oversampled render of one voice, decimated in place
+    double *os_inputs;          // Signal inputs held over each group of sub-samples, inlet by inlet
+    double *os_events;          // Oversampled events of one voice
+    double *os_work;            // Even/odd split of one decimator stage
+    
+    // Phase accumulator (@accum attribute)
+    t_symbol *accum;            // double (default) or fixed
+    long accum_fixed;           // 1 = 24.40 fixed-point phase, picked up by each voice in perform
+    
+    // Wavetable playback (@quality and @tablesize attributes)
+    t_symbol *quality;          // exact (default) or table
+    long quality_table;         // 1 = play shared wavetables when the inputs allow it
+    long table_size;            // Points per cycle in table mode
+    t_physics_table *volatile table;    // Table perform plays, swapped once the next one is ready
+    t_physics_table *table_want;        // Table for the current float parameters, still rendering
+    long table_pending;                 // 1 while table_want (NULL = none) is to replace table
+    t_physics_table *table_retired[PHYSICSLFO_TABLE_RETIRED];   // Replaced, perform may still read them
+    unsigned long table_retired_at[PHYSICSLFO_TABLE_RETIRED];   // sync_reads when each was replaced
+    void *table_clock;                  // Polls for the wanted table and the retired ones
     
 } t_physicslfo;
 
+// Perform routine signature, one specialization per inlet connection pattern
+typedef void (*t_physicslfo_perform)(t_physicslfo *x, t_object *dsp64, double **ins, long numins,
+                                     double **outs, long numouts, long sampleframes, long flags, void *userparam);
+
 // Function prototypes
 void *physicslfo_new(t_symbol *s, long argc, t_atom *argv);
 void physicslfo_free(t_physicslfo *x);
 void physicslfo_dsp64(t_physicslfo *x, t_object *dsp64, short *count, double samplerate, 
                       long maxvectorsize, long flags);
-void physicslfo_perform64(t_physicslfo *x, t_object *dsp64, double **ins, long numins, 
-                          double **outs, long numouts, long sampleframes, long flags, void *userparam);
 void physicslfo_float(t_physicslfo *x, double f);
 void physicslfo_int(t_physicslfo *x, long n);
 void physicslfo_bang(t_physicslfo *x);
 void physicslfo_looping(t_physicslfo *x, long n);
 void physicslfo_phase(t_physicslfo *x, double f);
+void physicslfo_voicebang(t_physicslfo *x, long n);
+void physicslfo_getstats(t_physicslfo *x);
+void physicslfo_getstate(t_physicslfo *x);
+void physicslfo_setstate(t_physicslfo *x, t_symbol *s, long argc, t_atom *argv);
+void physicslfo_state_tick(t_physicslfo *x);
+void physicslfo_plugin(t_physicslfo *x, t_symbol *path);
+void physicslfo_render(t_physicslfo *x, t_symbol *s, long argc, t_atom *argv);
+void *physicslfo_render_thread(t_physicslfo *x);
+void physicslfo_render_finish(t_physicslfo *x);
+void physicslfo_trigger_voice(t_physics_voice *v, long envelope);
+void physicslfo_jitter_setup(t_physics_voice *v, const double *jitter);
+void physicslfo_publish_params(t_physicslfo *x);
+long physicslfo_push_command(t_physicslfo *x, long type, long voice, long envelope, double value);
+void physicslfo_ramp_init(t_physicslfo_ramp *r, double value);
+long physicslfo_multichanneloutputs(t_physicslfo *x, long index);
 void physicslfo_assist(t_physicslfo *x, void *b, long m, long a, char *s);
+t_max_err physicslfo_engine_set(t_physicslfo *x, void *attr, long argc, t_atom *argv);
+t_max_err physicslfo_precision_set(t_physicslfo *x, void *attr, long argc, t_atom *argv);
+t_max_err physicslfo_decimate_set(t_physicslfo *x, void *attr, long argc, t_atom *argv);
+t_max_err physicslfo_interp_set(t_physicslfo *x, void *attr, long argc, t_atom *argv);
+t_max_err physicslfo_accum_set(t_physicslfo *x, void *attr, long argc, t_atom *argv);
+t_max_err physicslfo_quality_set(t_physicslfo *x, void *attr, long argc, t_atom *argv);
+t_max_err physicslfo_tablesize_set(t_physicslfo *x, void *attr, long argc, t_atom *argv);
+t_max_err physicslfo_chans_set(t_physicslfo *x, void *attr, long argc, t_atom *argv);
+t_max_err physicslfo_taps_set(t_physicslfo *x, void *attr, long argc, t_atom *argv);
+t_max_err physicslfo_events_set(t_physicslfo *x, void *attr, long argc, t_atom *argv);
+t_max_err physicslfo_offsets_set(t_physicslfo *x, void *attr, long argc, t_atom *argv);
+t_max_err physicslfo_smooth_set(t_physicslfo *x, void *attr, long argc, t_atom *argv);
+t_max_err physicslfo_jitter_set(t_physicslfo *x, void *attr, long argc, t_atom *argv);
+t_max_err physicslfo_seed_set(t_physicslfo *x, void *attr, long argc, t_atom *argv);
+t_max_err physicslfo_profile_set(t_physicslfo *x, void *attr, long argc, t_atom *argv);
+t_max_err physicslfo_oversample_set(t_physicslfo *x, void *attr, long argc, t_atom *argv);
+void physicslfo_oversample_setup(t_physicslfo *x, long maxvectorsize);
+void physicslfo_oversample_free(t_physicslfo *x);
+t_max_err physicslfo_sync_set(t_physicslfo *x, void *attr, long argc, t_atom *argv);
+t_max_err physicslfo_transport_set(t_physicslfo *x, void *attr, long argc, t_atom *argv);
 
-// Physics simulation functions
-double simulate_bounce(t_physicslfo *x, double t, double param, double damping);
-double simulate_elastic(t_physicslfo *x, double t, double tension, double damping);
-double simulate_bounce_spin(t_physicslfo *x, double t, double param, double damping);
-double simulate_elastic_overshoot(t_physicslfo *x, double t, double tension, double damping);
-double simulate_multibounce(t_physicslfo *x, double t, double param, double damping);
-double simulate_wobble(t_physicslfo *x, double t, double tension, double damping);
+// Specialized perform routines, indexed by inlet connection pattern
+static const t_physicslfo_perform physicslfo_perform_routines[32];
+static void physicslfo_perform64_profile(t_physicslfo *x, t_object *dsp64, double **ins, long numins,
+                                         double **outs, long numouts, long sampleframes, long flags,
+                                         void *userparam);
+
+// Profiling
+void physicslfo_timer_init(void);
+void physicslfo_stats_clear(t_physicslfo_stats *stats);
+int physicslfo_stats_read(t_physicslfo *x, t_physicslfo_stats *out);
+double physicslfo_stats_p99(const t_physicslfo_stats *stats);
 
 // Helper functions
-void reset_physics_state(t_physicslfo *x);
 void print_physics_info(t_physicslfo *x, long type);
+void physicslfo_log_type(t_physicslfo *x, long type);
+void physicslfo_log_tick(t_physicslfo *x);
+void physicslfo_log_flush(t_physicslfo *x, t_symbol *s, short argc, t_atom *argv);
+void physicslfo_idle_tick(t_physicslfo *x);
+
+// Transport sync
+int physicslfo_sync_parse(t_symbol *s, double *notes, double *bars);
+void physicslfo_sync_update(t_physicslfo *x);
+void physicslfo_sync_retire_tick(t_physicslfo *x);
+
+// Physics types
+long physicslfo_type_register(const char *name, const t_physicslfo_plugin *plugin);
+
+// Wavetable cache
+t_physics_table *physics_table_acquire(long type, long param_step, long damping_step, long size);
+void physics_table_release(t_physics_table *table);
+void physics_table_render(t_physics_table *table);
+void physicslfo_table_update(t_physicslfo *x);
+void physicslfo_table_tick(t_physicslfo *x);
 
 // Class pointer
 static t_class *physicslfo_class = NULL;
 
+// Class-wide physics types, appended by the main thread and read by perform
+static t_physicslfo_type physicslfo_types[PHYSICSLFO_MAX_TYPES];
+static volatile unsigned long physicslfo_type_count = 0;
+
+// Guards the class-wide wavetable cache
+static t_critical physicslfo_table_lock = NULL;
+
+// Renders cached tables off the message and audio threads, started on first use
+static t_systhread physicslfo_table_worker = NULL;
+static t_systhread_mutex physicslfo_table_worker_mutex = NULL;
+static t_systhread_cond physicslfo_table_worker_cond = NULL;
+static long physicslfo_table_jobs = 0;     // Wake-ups not yet seen by the worker
+
 //----------------------------------------------------------------------------------------------
 
 void ext_main(void *r) {
@@ -121,6 +536,117 @@ void ext_main(void *r) {
     class_addmethod(c, (method)physicslfo_bang, "bang", A_CANT, 0);
     class_addmethod(c, (method)physicslfo_looping, "looping", A_LONG, 0);
     class_addmethod(c, (method)physicslfo_phase, "phase", A_FLOAT, 0);
+    class_addmethod(c, (method)physicslfo_voicebang, "voicebang", A_LONG, 0);
+    class_addmethod(c, (method)physicslfo_getstats, "getstats", 0);
+    class_addmethod(c, (method)physicslfo_getstate, "getstate", 0);
+    class_addmethod(c, (method)physicslfo_setstate, "setstate", A_GIMME, 0);
+    class_addmethod(c, (method)physicslfo_render, "render", A_GIMME, 0);
+    class_addmethod(c, (method)physicslfo_plugin, "plugin", A_SYM, 0);
+    class_addmethod(c, (method)physicslfo_multichanneloutputs, "multichanneloutputs", A_CANT, 0);
+    
+    CLASS_ATTR_SYM(c, "engine", 0, t_physicslfo, engine);
+    CLASS_ATTR_ACCESSORS(c, "engine", NULL, physicslfo_engine_set);
+    CLASS_ATTR_ENUM(c, "engine", 0, "closed recursive");
+    CLASS_ATTR_LABEL(c, "engine", 0, "Render Engine");
+    
+    CLASS_ATTR_SYM(c, "precision", 0, t_physicslfo, precision);
+    CLASS_ATTR_ACCESSORS(c, "precision", NULL, physicslfo_precision_set);
+    CLASS_ATTR_ENUM(c, "precision", 0, "double single");
+    CLASS_ATTR_LABEL(c, "precision", 0, "Curve Precision");
+    
+    CLASS_ATTR_LONG(c, "decimate", 0, t_physicslfo, decimate);
+    CLASS_ATTR_ACCESSORS(c, "decimate", NULL, physicslfo_decimate_set);
+    CLASS_ATTR_LABEL(c, "decimate", 0, "Control-Rate Decimation");
+    
+    CLASS_ATTR_SYM(c, "interp", 0, t_physicslfo, interp);
+    CLASS_ATTR_ACCESSORS(c, "interp", NULL, physicslfo_interp_set);
+    CLASS_ATTR_ENUM(c, "interp", 0, "linear cubic");
+    CLASS_ATTR_LABEL(c, "interp", 0, "Decimation Interpolation");
+    
+    CLASS_ATTR_LONG(c, "morph", 0, t_physicslfo, morph);
+    CLASS_ATTR_STYLE_LABEL(c, "morph", 0, "onoff", "Morph Between Types");
+    CLASS_ATTR_FILTER_CLIP(c, "morph", 0, 1);
+    
+    CLASS_ATTR_LONG(c, "audiorate", 0, t_physicslfo, audiorate);
+    CLASS_ATTR_STYLE_LABEL(c, "audiorate", 0, "onoff", "Audio-Rate Mode");
+    CLASS_ATTR_FILTER_CLIP(c, "audiorate", 0, 1);
+    
+    CLASS_ATTR_LONG(c, "oversample", 0, t_physicslfo, oversample);
+    CLASS_ATTR_ACCESSORS(c, "oversample", NULL, physicslfo_oversample_set);
+    CLASS_ATTR_LABEL(c, "oversample", 0, "Oversampling");
+    
+    CLASS_ATTR_SYM(c, "accum", 0, t_physicslfo, accum);
+    CLASS_ATTR_ACCESSORS(c, "accum", NULL, physicslfo_accum_set);
+    CLASS_ATTR_ENUM(c, "accum", 0, "double fixed");
+    CLASS_ATTR_LABEL(c, "accum", 0, "Phase Accumulator");
+    
+    CLASS_ATTR_SYM(c, "quality", 0, t_physicslfo, quality);
+    CLASS_ATTR_ACCESSORS(c, "quality", NULL, physicslfo_quality_set);
+    CLASS_ATTR_ENUM(c, "quality", 0, "exact table");
+    CLASS_ATTR_LABEL(c, "quality", 0, "Render Quality");
+    
+    CLASS_ATTR_LONG(c, "tablesize", 0, t_physicslfo, table_size);
+    CLASS_ATTR_ACCESSORS(c, "tablesize", NULL, physicslfo_tablesize_set);
+    CLASS_ATTR_LABEL(c, "tablesize", 0, "Wavetable Size");
+    
+    CLASS_ATTR_LONG(c, "chans", 0, t_physicslfo, chans);
+    CLASS_ATTR_ACCESSORS(c, "chans", NULL, physicslfo_chans_set);
+    CLASS_ATTR_LABEL(c, "chans", 0, "Number of Voices");
+    
+    CLASS_ATTR_LONG(c, "taps", 0, t_physicslfo, taps);
+    CLASS_ATTR_ACCESSORS(c, "taps", NULL, physicslfo_taps_set);
+    CLASS_ATTR_LABEL(c, "taps", 0, "Phase-Offset Taps");
+    
+    CLASS_ATTR_LONG(c, "events", 0, t_physicslfo, events);
+    CLASS_ATTR_ACCESSORS(c, "events", NULL, physicslfo_events_set);
+    CLASS_ATTR_STYLE_LABEL(c, "events", 0, "onoff", "Event Outlet");
+    
+    CLASS_ATTR_DOUBLE_VARSIZE(c, "offsets", 0, t_physicslfo, tap_offsets, tap_offsets_count, PHYSICSLFO_MAX_TAPS);
+    CLASS_ATTR_ACCESSORS(c, "offsets", NULL, physicslfo_offsets_set);
+    CLASS_ATTR_LABEL(c, "offsets", 0, "Tap Phase Offsets");
+    
+    CLASS_ATTR_DOUBLE(c, "smooth", 0, t_physicslfo, smooth_ms);
+    CLASS_ATTR_ACCESSORS(c, "smooth", NULL, physicslfo_smooth_set);
+    CLASS_ATTR_LABEL(c, "smooth", 0, "Parameter Smoothing (ms)");
+    
+    CLASS_ATTR_DOUBLE_VARSIZE(c, "jitter", 0, t_physicslfo, jitter, jitter_count, PHYSICS_JITTER_AMOUNTS);
+    CLASS_ATTR_ACCESSORS(c, "jitter", NULL, physicslfo_jitter_set);
+    CLASS_ATTR_LABEL(c, "jitter", 0, "Per-Cycle Jitter (energy damping physics)");
+    
+    CLASS_ATTR_LONG(c, "seed", 0, t_physicslfo, seed);
+    CLASS_ATTR_ACCESSORS(c, "seed", NULL, physicslfo_seed_set);
+    CLASS_ATTR_LABEL(c, "seed", 0, "Jitter Seed");
+    
+    CLASS_ATTR_SYM(c, "sync", 0, t_physicslfo, sync);
+    CLASS_ATTR_ACCESSORS(c, "sync", NULL, physicslfo_sync_set);
+    CLASS_ATTR_LABEL(c, "sync", 0, "Transport Sync Period");
+    
+    CLASS_ATTR_SYM(c, "transport", 0, t_physicslfo, transport);
+    CLASS_ATTR_ACCESSORS(c, "transport", NULL, physicslfo_transport_set);
+    CLASS_ATTR_LABEL(c, "transport", 0, "Transport Name");
+    
+    CLASS_ATTR_LONG(c, "verbose", 0, t_physicslfo, verbose);
+    CLASS_ATTR_STYLE_LABEL(c, "verbose", 0, "onoff", "Post Type Info");
+    CLASS_ATTR_FILTER_CLIP(c, "verbose", 0, 1);
+    
+    CLASS_ATTR_LONG(c, "profile", 0, t_physicslfo, profile);
+    CLASS_ATTR_ACCESSORS(c, "profile", NULL, physicslfo_profile_set);
+    CLASS_ATTR_STYLE_LABEL(c, "profile", 0, "onoff", "Profile DSP Cost");
+    
+    CLASS_ATTR_LONG(c, "idle", ATTR_SET_OPAQUE_USER, t_physicslfo, idle);
+    CLASS_ATTR_STYLE_LABEL(c, "idle", ATTR_SET_OPAQUE_USER, "onoff", "Envelopes Settled");
+    
+    physicslfo_type_register("bounce", NULL);
+    physicslfo_type_register("damped decay", NULL);
+    physicslfo_type_register("bounce+spin", NULL);
+    physicslfo_type_register("overshoot", NULL);
+    physicslfo_type_register("multi-bounce", NULL);
+    physicslfo_type_register("wobble", NULL);
+    
+    critical_new(&physicslfo_table_lock);
+    systhread_mutex_new(&physicslfo_table_worker_mutex, 0);
+    systhread_cond_new(&physicslfo_table_worker_cond, 0);
+    physicslfo_timer_init();
     
     class_dspinit(c);
     class_register(CLASS_BOX, c);
@@ -133,12 +659,10 @@ void *physicslfo_new(t_symbol *s, long argc, t_atom *argv) {
     t_physicslfo *x = (t_physicslfo *)object_alloc(physicslfo_class);
     
     if (x) {
-        // lores~ pattern: 4 signal inlets (freq, type, physics, damping)
-        dsp_setup((t_pxobject *)x, 4);
-        outlet_new(x, "signal");
+        // lores~ pattern: 4 signal inlets (freq, type, physics, damping) plus a trigger inlet
+        dsp_setup((t_pxobject *)x, PHYSICSLFO_NUM_INLETS);
         
         // Initialize core state
-        x->phase = 0.0;
         x->sr = sys_getsr();
         x->sr_inv = 1.0 / x->sr;
         
@@ -153,27 +677,206 @@ void *physicslfo_new(t_symbol *s, long argc, t_atom *argv) {
         x->type_has_signal = 0;
         x->physics_has_signal = 0;
         x->damping_has_signal = 0;
-        
-        // Initialize physics state
-        reset_physics_state(x);
+        x->trigger_has_signal = 0;
         
         // Initialize mode control (looping mode is default)
         x->looping_mode = 1;        // 1 = looping, 0 = envelope
-        x->envelope_active = 0;     // Envelope not active initially
         
-        // Process creation arguments: [type] [physics] [damping]
-        if (argc >= 1 && atom_gettype(argv) == A_LONG) {
-            x->type_float = CLAMP(atom_getlong(argv), 0, 5);
+        // Message -> audio handoff
+        critical_new(&x->message_lock);
+        x->pending_seq = 0;
+        x->params_seq = 0;
+        x->queue_write = 0;
+        x->queue_read = 0;
+        x->smooth_ms = 0.0;
+        
+        // No jitter until @jitter is set; the default seed still gives a fixed sequence
+        for (long i = 0; i < PHYSICS_JITTER_AMOUNTS; i++) {
+            x->jitter[i] = 0.0;
+        }
+        x->jitter_count = 0;
+        x->seed = 0;
+        x->jitter_epoch = 1;
+        
+        // Type info is only posted with @verbose 1, deferred and rate limited
+        x->verbose = 0;
+        x->log_clock = clock_new(x, (method)physicslfo_log_tick);
+        x->log_type = 0;
+        x->log_pending = 0;
+        x->log_last = 0;
+        
+        // Settled envelopes are reported through a clock, never from perform
+        x->idle = 0;
+        x->idle_clock = clock_new(x, (method)physicslfo_idle_tick);
+        
+        // State snapshots are taken by perform and sent from the scheduler
+        x->state_in = NULL;
+        x->state_in_pending = 0;
+        x->state_out = NULL;
+        x->state_out_looping = 1;
+        x->state_out_seq = 0;
+        x->state_clock = clock_new(x, (method)physicslfo_state_tick);
+        
+        // Transport sync is off until @sync names a period
+        x->sync = gensym("off");
+        x->sync_notes = 0.0;
+        x->sync_bars = 0.0;
+        x->transport = gensym("");
+        x->sync_itm = NULL;
+        x->sync_reads = 0;
+        for (long i = 0; i < PHYSICSLFO_SYNC_RETIRED; i++) {
+            x->sync_retired[i] = NULL;
+            x->sync_retired_at[i] = 0;
+        }
+        x->sync_clock = clock_new(x, (method)physicslfo_sync_retire_tick);
+        x->sync_active = 0;
+        x->sync_phase = 0.0;
+        
+        // No render runs until the render message starts one
+        x->render_thread = NULL;
+        x->render.data = NULL;
+        x->render.cancel = 0;
+        x->render_qelem = qelem_new(x, (method)physicslfo_render_finish);
+        
+        // Profiling is off until @profile 1; stats start out cleared
+        x->profile = 0;
+        physicslfo_stats_clear(&x->stats);
+        x->stats_seq = 0;
+        x->stats_reset = 0;
+        x->stats_reset_done = 0;
+        
+        // Voices are allocated once @chans is known
+        x->chans = 1;
+        x->voices = NULL;
+        x->taps = 1;
+        x->events = 0;
+        x->tap_offsets_count = 0;
+        for (long i = 0; i < PHYSICSLFO_MAX_TAPS; i++) {
+            x->tap_offsets[i] = 0.0;
         }
-        if (argc >= 2 && (atom_gettype(argv + 1) == A_FLOAT || atom_gettype(argv + 1) == A_LONG)) {
+        
+        // Initialize attributes
+        x->engine = gensym("closed");
+        x->engine_recursive = 0;
+        x->precision = gensym("double");
+        x->precision_single = 0;
+        x->decimate = 1;
+        x->interp = gensym("linear");
+        x->interp_cubic = 0;
+        x->morph = 0;
+        x->audiorate = 0;
+        x->oversample = 1;
+        x->os_factor = 1;
+        x->os_vectorsize = 0;
+        x->os_delay = 0;
+        x->os_state = NULL;
+        x->os_buffer = NULL;
+        x->os_inputs = NULL;
+        x->os_events = NULL;
+        x->os_work = NULL;
+        x->accum = gensym("double");
+        x->accum_fixed = 0;
+        x->quality = gensym("exact");
+        x->quality_table = 0;
+        x->table_size = PHYSICSLFO_TABLE_DEFAULT_SIZE;
+        x->table = NULL;
+        x->table_want = NULL;
+        x->table_pending = 0;
+        for (long i = 0; i < PHYSICSLFO_TABLE_RETIRED; i++) {
+            x->table_retired[i] = NULL;
+            x->table_retired_at[i] = 0;
+        }
+        x->table_clock = clock_new(x, (method)physicslfo_table_tick);
+        
+        // Process creation arguments: [type] [physics] [damping] followed by @attributes
+        long positional = attr_args_offset((short)argc, argv);
+        
+        if (positional >= 1 && atom_gettype(argv) == A_LONG) {
+            x->type_float = CLAMP(atom_getlong(argv), 0, (long)physicslfo_type_count - 1);
+        }
+        if (positional >= 2 && (atom_gettype(argv + 1) == A_FLOAT || atom_gettype(argv + 1) == A_LONG)) {
             x->physics_float = CLAMP(atom_getfloat(argv + 1), 0.0, 1.0);
         }
-        if (argc >= 3 && (atom_gettype(argv + 2) == A_FLOAT || atom_gettype(argv + 2) == A_LONG)) {
+        if (positional >= 3 && (atom_gettype(argv + 2) == A_FLOAT || atom_gettype(argv + 2) == A_LONG)) {
             x->damping_float = CLAMP(atom_getfloat(argv + 2), 0.0, 1.0);
         }
+        attr_args_process(x, (short)argc, argv);
+        
+        // Taps fan one simulation out to plain outlets, so they replace @chans.
+        // Offsets that were not given are spread evenly over the cycle
+        if (x->taps > 1 && x->chans > 1) {
+            post("physicslfo~: @taps replaces @chans, using %ld taps on one voice", x->taps);
+            x->chans = 1;
+        }
+        for (long i = x->tap_offsets_count; i < x->taps; i++) {
+            x->tap_offsets[i] = (double)i / (double)x->taps;
+        }
         
-        // Print initial physics type info
-        print_physics_info(x, (long)x->type_float);
+        // Allocate and initialize the voices, then the (multichannel) outlet
+        x->voices = (t_physics_voice *)sysmem_newptrclear(PHYSICSLFO_VOICE_COUNT(x) * sizeof(t_physics_voice));
+        x->state_in = (t_physics_voice_state *)sysmem_newptrclear(PHYSICSLFO_VOICE_COUNT(x) *
+                                                                  sizeof(t_physics_voice_state));
+        x->state_out = (t_physics_voice_state *)sysmem_newptrclear(PHYSICSLFO_VOICE_COUNT(x) *
+                                                                   sizeof(t_physics_voice_state));
+        if (!x->voices || !x->state_in || !x->state_out) {
+            object_error((t_object *)x, "out of memory for %ld voices", PHYSICSLFO_VOICE_COUNT(x));
+            object_free(x);     // physicslfo_free releases whatever was set up so far
+            return NULL;
+        }
+        for (long i = 0; i < PHYSICSLFO_VOICE_COUNT(x); i++) {
+            t_physics_voice *v = x->voices + i;
+            
+            v->phase = 0.0;
+            v->envelope_active = 0;     // Envelope not active initially
+            v->trigger_prev = 0.0;
+            v->idle = 0;
+            v->phase_fixed = 0;
+            v->phase_fixed_on = 0;
+            v->event_restart = 0;
+            v->event_prev[0] = v->event_prev[1] = 0.0;
+            reset_physics_state(v);
+            physics_coefs_build(&v->coefs, CLAMP(x->physics_float, 0.0, 1.0), CLAMP(x->damping_float, 0.0, 1.0));
+        }
+        physicslfo_publish_params(x);
+        x->params = x->pending;     // No audio thread yet, start in sync
+        x->params_seq = x->pending_seq;
+        physicslfo_ramp_init(&x->ramp_freq, x->params.freq);
+        physicslfo_ramp_init(&x->ramp_physics, x->params.physics);
+        physicslfo_ramp_init(&x->ramp_damping, x->params.damping);
+        
+        for (long i = 0; i < PHYSICSLFO_NUM_INLETS; i++) {
+            x->inlet_chans[i] = 1;
+            x->inlet_offset[i] = i;
+        }
+        
+        // Outlets are created right to left
+        x->info_outlet = outlet_new(x, NULL);
+        x->idle_outlet = intout((t_object *)x);
+        if (x->events) {
+            // Events are cleared at block start, before the inputs are read
+            x->ob.z_misc |= Z_NO_INPLACE;
+            outlet_new(x, x->chans > 1 ? "multichannelsignal" : "signal");
+        }
+        if (x->chans > 1) {
+            // Each voice reads its own channel of a multichannel input, and no
+            // output may alias an input another voice still has to read
+            x->ob.z_misc |= Z_NO_INPLACE | Z_MC_INLETS;
+            outlet_new(x, "multichannelsignal");
+        } else if (x->taps > 1) {
+            // The taps are written one after another from the shared phase,
+            // so none of them may alias an input still to be read
+            x->ob.z_misc |= Z_NO_INPLACE;
+            for (long i = 0; i < x->taps; i++) {
+                outlet_new(x, "signal");
+            }
+        } else {
+            outlet_new(x, "signal");
+        }
+        
+        // Report the initial physics type
+        if (x->verbose) {
+            physicslfo_log_type(x, (long)x->type_float);
+        }
     }
     
     return x;
@@ -183,6 +886,66 @@ void *physicslfo_new(t_symbol *s, long argc, t_atom *argv) {
 
 void physicslfo_free(t_physicslfo *x) {
     dsp_free((t_pxobject *)x);
+    
+    // Stop a running render; its result is dropped with the object
+    if (x->render_thread) {
+        unsigned int status;
+        
+        x->render.cancel = 1;
+        systhread_join(x->render_thread, &status);
+        x->render_thread = NULL;
+    }
+    if (x->render_qelem) {
+        qelem_free(x->render_qelem);
+    }
+    if (x->render.data) {
+        sysmem_freeptr(x->render.data);
+    }
+    
+    // Out of the DSP chain, so no table is in use any more
+    if (x->table_clock) {
+        object_free(x->table_clock);
+    }
+    physics_table_release(x->table);
+    physics_table_release(x->table_want);
+    for (long i = 0; i < PHYSICSLFO_TABLE_RETIRED; i++) {
+        physics_table_release(x->table_retired[i]);
+    }
+    if (x->voices) {
+        sysmem_freeptr(x->voices);
+    }
+    if (x->state_in) {
+        sysmem_freeptr(x->state_in);
+    }
+    if (x->state_out) {
+        sysmem_freeptr(x->state_out);
+    }
+    physicslfo_oversample_free(x);
+    if (x->message_lock) {
+        critical_free(x->message_lock);
+    }
+    if (x->log_clock) {
+        object_free(x->log_clock);
+    }
+    if (x->idle_clock) {
+        object_free(x->idle_clock);
+    }
+    if (x->state_clock) {
+        object_free(x->state_clock);
+    }
+    
+    // The DSP chain no longer holds this object, so both references can go
+    if (x->sync_clock) {
+        object_free(x->sync_clock);
+    }
+    for (long i = 0; i < PHYSICSLFO_SYNC_RETIRED; i++) {
+        if (x->sync_retired[i]) {
+            itm_dereference(x->sync_retired[i]);
+        }
+    }
+    if (x->sync_itm) {
+        itm_dereference(x->sync_itm);
+    }
 }
 
 //----------------------------------------------------------------------------------------------
@@ -197,206 +960,2365 @@ void physicslfo_dsp64(t_physicslfo *x, t_object *dsp64, short *count, double sam
     x->type_has_signal = count[1];
     x->physics_has_signal = count[2];
     x->damping_has_signal = count[3];
+    x->trigger_has_signal = count[4];
     
-    object_method(dsp64, gensym("dsp_add64"), x, physicslfo_perform64, 0, NULL);
+    // Channels per inlet: multichannel inputs are laid out inlet by inlet in the
+    // perform ins array
+    long offset = 0;
+    for (long inlet = 0; inlet < PHYSICSLFO_NUM_INLETS; inlet++) {
+        long chans = (x->chans > 1) ? (long)object_method(dsp64, gensym("getnuminputchannels"), x, inlet) : 1;
+        
+        x->inlet_chans[inlet] = chans > 0 ? chans : 1;
+        x->inlet_offset[inlet] = offset;
+        offset += x->inlet_chans[inlet];
+    }
+    
+    // @oversample: decimator buffers and kernels, never allocated in perform
+    physicslfo_oversample_setup(x, maxvectorsize);
+    
+    // Register the perform routine specialized for this connection pattern
+    long pattern = (x->freq_has_signal ? 16 : 0) | (x->type_has_signal ? 8 : 0)
+                 | (x->physics_has_signal ? 4 : 0) | (x->damping_has_signal ? 2 : 0)
+                 | (x->trigger_has_signal ? 1 : 0);
+    
+    if (x->profile) {
+        // The timed wrapper calls the specialized routine passed as userparam,
+        // so an instance without @profile runs exactly the untimed code
+        object_method(dsp64, gensym("dsp_add64"), x, physicslfo_perform64_profile, 0,
+                      (void *)physicslfo_perform_routines[pattern]);
+    } else {
+        object_method(dsp64, gensym("dsp_add64"), x, physicslfo_perform_routines[pattern], 0, NULL);
+    }
 }
 
-//----------------------------------------------------------------------------------------------
-
-void physicslfo_perform64(t_physicslfo *x, t_object *dsp64, double **ins, long numins, 
-                          double **outs, long numouts, long sampleframes, long flags, void *userparam) {
-    // Input buffers for all 4 inlets
-    double *freq_in = ins[0];
-    double *type_in = ins[1];
-    double *physics_in = ins[2];
-    double *damping_in = ins[3];
+// @oversample buffers for blocks of up to maxvectorsize samples. The voices'
+// histories are kept while the multiple and block size stay the same, so
+// rebuilding the DSP chain doesn't restart the decimators. Taps share one
+// phase across their outlets and always render at the sample rate.
+void physicslfo_oversample_setup(t_physicslfo *x, long maxvectorsize) {
+    long factor = x->taps > 1 ? 1 : x->oversample;
+    long n = maxvectorsize * factor;
+    long stage_rate;
     
-    // Output buffer
-    double *out = outs[0];
+    if (x->taps > 1 && x->oversample > 1) {
+        post("physicslfo~: @oversample does not apply to @taps");
+    }
+    if (factor == x->os_factor && maxvectorsize == x->os_vectorsize) return;
     
-    long n = sampleframes;
-    double phase = x->phase;
-    double sr_inv = x->sr_inv;
+    physicslfo_oversample_free(x);
+    if (factor <= 1 || maxvectorsize <= 0) return;
     
-    while (n--) {
-        // lores~ pattern: choose signal vs float for each inlet
-        double freq = x->freq_has_signal ? *freq_in++ : x->freq_float;
-        double type_val = x->type_has_signal ? *type_in++ : x->type_float;
-        double physics_param = x->physics_has_signal ? *physics_in++ : x->physics_float;
-        double damping = x->damping_has_signal ? *damping_in++ : x->damping_float;
-        
-        // Clamp parameters
-        freq = CLAMP(freq, 0.0, 1000.0);  // 0-1000 Hz
-        long type = (long)CLAMP(type_val, 0.0, 5.0);  // 0-5 physics types
-        physics_param = CLAMP(physics_param, 0.0, 1.0);
-        damping = CLAMP(damping, 0.0, 1.0);
-        
-        // Handle mode-specific phase updates
-        double value = 0.0;
-        
-        if (x->looping_mode) {
-            // Looping mode: continuous phase accumulation
-            phase += freq * sr_inv;
-            
-            // Wrap phase and reset physics state when cycle completes
-            if (phase >= 1.0) {
-                phase -= 1.0;
-                reset_physics_state(x);
-            }
-            while (phase < 0.0) phase += 1.0;
-            
-        } else {
-            // Envelope mode: let physics play out naturally (no artificial cutoff)
-            if (x->envelope_active) {
-                phase += freq * sr_inv;
-                
-                // Mark first cycle as complete but continue physics simulation
-                if (phase >= 1.0) {
-                    x->envelope_active = 0;  // Mark first cycle complete but keep going
-                }
-            } else {
-                // Continue physics simulation beyond first cycle - let natural decay occur
-                phase += freq * sr_inv;
-            }
-        }
-        
-        // Apply physics simulation based on type
-        switch (type) {
-            case 0:  // Bounce
-                value = simulate_bounce(x, phase, physics_param, damping);
-                break;
-            case 1:  // Elastic
-                value = simulate_elastic(x, phase, physics_param, damping);
-                break;
-            case 2:  // Bounce with spin
-                value = simulate_bounce_spin(x, phase, physics_param, damping);
-                break;
-            case 3:  // Elastic overshoot
-                value = simulate_elastic_overshoot(x, phase, physics_param, damping);
-                break;
-            case 4:  // Multi-bounce
-                value = simulate_multibounce(x, phase, physics_param, damping);
-                break;
-            case 5:  // Wobble
-                value = simulate_wobble(x, phase, physics_param, damping);
-                break;
-        }
-        
-        // Store for next sample
-        x->last_value = value;
-        
-        // Output unipolar range (0 to 1) - natural for physics simulations
-        *out++ = value;
+    x->os_state = (t_physicslfo_oversampler *)sysmem_newptrclear(PHYSICSLFO_VOICE_COUNT(x) *
+                                                                  sizeof(t_physicslfo_oversampler));
+    x->os_buffer = (double *)sysmem_newptrclear(n * sizeof(double));
+    x->os_inputs = (double *)sysmem_newptrclear(PHYSICSLFO_NUM_INLETS * n * sizeof(double));
+    x->os_events = (double *)sysmem_newptrclear(n * sizeof(double));
+    x->os_work = (double *)sysmem_newptrclear((PHYSICS_HALFBAND_HISTORY(PHYSICSLFO_OVERSAMPLE_TAPS) + n) *
+                                              sizeof(double));
+    if (!x->os_state || !x->os_buffer || !x->os_inputs || !x->os_events || !x->os_work) {
+        object_error((t_object *)x, "out of memory for @oversample %ld", factor);
+        physicslfo_oversample_free(x);
+        return;
     }
     
-    x->phase = phase;
+    physics_halfband_design(x->os_kernel, PHYSICSLFO_OVERSAMPLE_TAPS);
+    physics_halfband_design(x->os_kernel_early, PHYSICSLFO_OVERSAMPLE_TAPS_EARLY);
+    
+    // Each stage delays by its taps at its output rate
+    x->os_delay = PHYSICSLFO_OVERSAMPLE_TAPS;
+    for (stage_rate = factor / 2; stage_rate > 1; stage_rate /= 2) {
+        x->os_delay += PHYSICSLFO_OVERSAMPLE_TAPS_EARLY / stage_rate;
+    }
+    x->os_factor = factor;
+    x->os_vectorsize = maxvectorsize;
+}
+
+void physicslfo_oversample_free(t_physicslfo *x) {
+    if (x->os_state) {
+        sysmem_freeptr(x->os_state);
+    }
+    if (x->os_buffer) {
+        sysmem_freeptr(x->os_buffer);
+    }
+    if (x->os_inputs) {
+        sysmem_freeptr(x->os_inputs);
+    }
+    if (x->os_events) {
+        sysmem_freeptr(x->os_events);
+    }
+    if (x->os_work) {
+        sysmem_freeptr(x->os_work);
+    }
+    x->os_state = NULL;
+    x->os_buffer = NULL;
+    x->os_inputs = NULL;
+    x->os_events = NULL;
+    x->os_work = NULL;
+    x->os_factor = 1;
+    x->os_vectorsize = 0;
+    x->os_delay = 0;
 }
 
 //----------------------------------------------------------------------------------------------
 
-void physicslfo_float(t_physicslfo *x, double f) {
-    // lores~ pattern: proxy_getinlet works on signal inlets for float routing
-    long inlet = proxy_getinlet((t_object *)x);
+//----------------------------------------------------------------------------------------------
+// Message Thread Handoff
+//----------------------------------------------------------------------------------------------
+// Message handlers never touch state the perform routine reads. Float
+// parameters and the looping mode are published as a snapshot guarded by a
+// sequence number (odd while being written), and discrete events (bang,
+// voicebang, phase, leaving looping mode) go through a single-producer /
+// single-consumer ring. Producers are serialized by message_lock, since
+// messages can arrive from both the main and the scheduler thread; the audio
+// thread never takes it and drains everything at block start.
+
+#if defined(_MSC_VER)
+#define PHYSICSLFO_LOAD_ACQUIRE(p) ((unsigned long)InterlockedCompareExchange((volatile LONG *)(p), 0, 0))
+#define PHYSICSLFO_LOAD_RELAXED(p) (*(p))
+#define PHYSICSLFO_STORE_RELEASE(p, v) InterlockedExchange((volatile LONG *)(p), (LONG)(v))
+#define PHYSICSLFO_LOAD_ACQUIRE_PTR(p) InterlockedCompareExchangePointer((PVOID volatile *)(p), NULL, NULL)
+#define PHYSICSLFO_STORE_RELEASE_PTR(p, v) InterlockedExchangePointer((PVOID volatile *)(p), (PVOID)(v))
+#define PHYSICSLFO_FENCE_ACQUIRE() MemoryBarrier()
+#define PHYSICSLFO_FENCE_RELEASE() MemoryBarrier()
+#else
+#define PHYSICSLFO_LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define PHYSICSLFO_LOAD_RELAXED(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define PHYSICSLFO_STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define PHYSICSLFO_LOAD_ACQUIRE_PTR(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define PHYSICSLFO_STORE_RELEASE_PTR(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define PHYSICSLFO_FENCE_ACQUIRE() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define PHYSICSLFO_FENCE_RELEASE() __atomic_thread_fence(__ATOMIC_RELEASE)
+#endif
+
+// Publish the message-side float parameters and looping mode (message thread)
+void physicslfo_publish_params(t_physicslfo *x) {
+    critical_enter(x->message_lock);
+    unsigned long seq = x->pending_seq;
     
-    switch (inlet) {
-        case 0: // Frequency inlet
-            x->freq_float = CLAMP(f, 0.0, 1000.0);
-            break;
-        case 1: // LFO type inlet
-            {
-                long new_type = (long)CLAMP(f, 0.0, 5.0);
-                x->type_float = (double)new_type;
-                print_physics_info(x, new_type);
-            }
-            break;
-        case 2: // Physics parameter inlet
-            x->physics_float = CLAMP(f, 0.0, 1.0);
-            break;
-        case 3: // Damping inlet
-            x->damping_float = CLAMP(f, 0.0, 1.0);
-            break;
+    PHYSICSLFO_STORE_RELEASE(&x->pending_seq, seq + 1);
+    PHYSICSLFO_FENCE_RELEASE();
+    x->pending.freq = x->freq_float;
+    x->pending.type = x->type_float;
+    x->pending.physics = x->physics_float;
+    x->pending.damping = x->damping_float;
+    x->pending.looping = x->looping_mode;
+    x->pending.smooth = x->smooth_ms;
+    x->pending.sync_notes = x->sync_notes;
+    x->pending.sync_bars = x->sync_bars;
+    for (long i = 0; i < x->taps; i++) {
+        x->pending.tap_offsets[i] = x->tap_offsets[i];
+    }
+    for (long i = 0; i < PHYSICS_JITTER_AMOUNTS; i++) {
+        x->pending.jitter[i] = x->jitter[i];
     }
+    x->pending.jitter_seed = x->seed;
+    x->pending.jitter_epoch = x->jitter_epoch;
+    PHYSICSLFO_STORE_RELEASE(&x->pending_seq, seq + 2);
+    critical_exit(x->message_lock);
 }
 
-//----------------------------------------------------------------------------------------------
+// Queue an event for the next block (message thread). With audio off nothing
+// drains the ring; once it is full further events are dropped, which only loses
+// redundant resets since the snapshot still carries the current mode. Returns
+// 1 if the event was queued.
+long physicslfo_push_command(t_physicslfo *x, long type, long voice, long envelope, double value) {
+    long queued = 0;
+    
+    critical_enter(x->message_lock);
+    unsigned long write = x->queue_write;
+    
+    if (write - PHYSICSLFO_LOAD_ACQUIRE(&x->queue_read) < PHYSICSLFO_QUEUE_SIZE) {
+        t_physicslfo_command *cmd = x->queue + (write & (PHYSICSLFO_QUEUE_SIZE - 1));
+        
+        cmd->type = type;
+        cmd->voice = voice;
+        cmd->envelope = envelope;
+        cmd->value = value;
+        PHYSICSLFO_STORE_RELEASE(&x->queue_write, write + 1);
+        queued = 1;
+    }
+    critical_exit(x->message_lock);
+    return queued;
+}
 
-void physicslfo_int(t_physicslfo *x, long n) {
-    // lores~ pattern: proxy_getinlet works on signal inlets for int routing
-    long inlet = proxy_getinlet((t_object *)x);
+void physicslfo_trigger_voice(t_physics_voice *v, long envelope) {
+    v->event_restart = 1;      // Reported at the start of the block (@events)
     
-    switch (inlet) {
-        case 0: // Frequency inlet - convert int to float
-            x->freq_float = CLAMP((double)n, 0.0, 1000.0);
-            break;
-        case 1: // LFO type inlet - direct int handling
-            {
-                long new_type = CLAMP(n, 0, 5);
-                x->type_float = (double)new_type;
-                print_physics_info(x, new_type);
-            }
-            break;
-        case 2: // Physics parameter inlet - convert int to float
-            x->physics_float = CLAMP((double)n, 0.0, 1.0);
-            break;
-        case 3: // Damping inlet - convert int to float
-            x->damping_float = CLAMP((double)n, 0.0, 1.0);
-            break;
+    if (!envelope) {
+        // Looping mode: reset phase and physics state
+        physics_voice_set_phase(v, 0.0);
+        reset_physics_state(v);
+    } else {
+        // Envelope mode: trigger new envelope cycle
+        physics_voice_set_phase(v, 0.0);
+        reset_physics_state(v);
+        v->envelope_active = 1;  // Start envelope
     }
 }
 
-//----------------------------------------------------------------------------------------------
+// Take the latest published parameters (audio thread)
+PHYSICSLFO_INLINE void physicslfo_load_params(t_physicslfo *x) {
+    unsigned long seq = PHYSICSLFO_LOAD_ACQUIRE(&x->pending_seq);
+    
+    if (seq != x->params_seq && !(seq & 1)) {
+        t_physicslfo_params snapshot = x->pending;
+        
+        PHYSICSLFO_FENCE_ACQUIRE();
+        if (PHYSICSLFO_LOAD_RELAXED(&x->pending_seq) == seq) {
+            x->params = snapshot;
+            x->params_seq = seq;
+        }
+        // Otherwise a new snapshot is being written; it is picked up next block
+    }
+}
 
-void physicslfo_bang(t_physicslfo *x) {
-    // lores~ pattern: proxy_getinlet works on signal inlets for message routing
-    long inlet = proxy_getinlet((t_object *)x);
+// Apply pending parameters, then events in the order they were sent (audio thread)
+PHYSICSLFO_INLINE void physicslfo_apply_messages(t_physicslfo *x) {
+    physicslfo_load_params(x);
     
-    if (inlet == 0) {  // First inlet - mode-specific behavior
-        if (x->looping_mode) {
-            // Looping mode: reset phase and physics state
-            x->phase = 0.0;
-            reset_physics_state(x);
-        } else {
-            // Envelope mode: trigger new envelope cycle
-            x->phase = 0.0;
-            reset_physics_state(x);
-            x->envelope_active = 1;  // Start envelope
+    unsigned long read = x->queue_read;
+    unsigned long write = PHYSICSLFO_LOAD_ACQUIRE(&x->queue_write);
+    
+    while (read != write) {
+        const t_physicslfo_command *cmd = x->queue + (read & (PHYSICSLFO_QUEUE_SIZE - 1));
+        long first = cmd->voice < 0 ? 0 : cmd->voice;
+        long last = cmd->voice < 0 ? PHYSICSLFO_VOICE_COUNT(x) - 1 : cmd->voice;
+        long i;
+        
+        if (cmd->type == PHYSICSLFO_CMD_GETSTATE) {
+            PHYSICSLFO_STORE_RELEASE(&x->state_out_seq, x->state_out_seq + 1);
+            PHYSICSLFO_FENCE_RELEASE();
         }
+        for (i = first; i <= last; i++) {
+            t_physics_voice *v = x->voices + i;
+            
+            switch (cmd->type) {
+                case PHYSICSLFO_CMD_TRIGGER:
+                    physicslfo_trigger_voice(v, cmd->envelope);
+                    break;
+                case PHYSICSLFO_CMD_PHASE:
+                    physics_voice_set_phase(v, cmd->value);
+                    reset_physics_state(v);  // Reset physics state for new phase position
+                    break;
+                case PHYSICSLFO_CMD_STOP_ENVELOPE:
+                    v->envelope_active = 0;
+                    break;
+                case PHYSICSLFO_CMD_SETSTATE:
+                    physics_voice_set_state(v, x->state_in + i);
+                    break;
+                case PHYSICSLFO_CMD_GETSTATE:
+                    physics_voice_get_state(v, x->state_out + i);
+                    break;
+            }
+        }
+        if (cmd->type == PHYSICSLFO_CMD_SETSTATE) {
+            // setstate published its looping mode before queueing, so reloading
+            // switches the mode on the same block as the state
+            physicslfo_load_params(x);
+            PHYSICSLFO_STORE_RELEASE(&x->state_in_pending, 0);
+        } else if (cmd->type == PHYSICSLFO_CMD_GETSTATE) {
+            x->state_out_looping = x->params.looping;
+            PHYSICSLFO_STORE_RELEASE(&x->state_out_seq, x->state_out_seq + 1);
+            clock_delay(x->state_clock, 0);
+        }
+        read++;
     }
+    PHYSICSLFO_STORE_RELEASE(&x->queue_read, read);
 }
 
 //----------------------------------------------------------------------------------------------
 
-void physicslfo_looping(t_physicslfo *x, long n) {
-    x->looping_mode = n ? 1 : 0;  // Convert to boolean
-    
-    if (!x->looping_mode) {
-        // Switched to envelope mode - stop any current envelope
-        x->envelope_active = 0;
+// Start a ramp already at rest on value
+void physicslfo_ramp_init(t_physicslfo_ramp *r, double value) {
+    r->value = value;
+    r->target = value;
+    r->step = 0.0;
+    r->remaining = 0;
+}
+
+// Head for a new target over the given number of samples (0 = jump)
+PHYSICSLFO_INLINE void physicslfo_ramp_retarget(t_physicslfo_ramp *r, double target, long samples) {
+    if (target != r->target) {
+        r->target = target;
+        if (samples > 0) {
+            r->step = (target - r->value) / samples;
+            r->remaining = samples;
+        } else {
+            r->value = target;
+            r->remaining = 0;
+        }
     }
 }
 
-//----------------------------------------------------------------------------------------------
+// Ramp value k samples after block start
+PHYSICSLFO_INLINE double physicslfo_ramp_at(const t_physicslfo_ramp *r, long k) {
+    return k < r->remaining ? r->value + r->step * k : r->target;
+}
 
-void physicslfo_phase(t_physicslfo *x, double f) {
-    if (x->looping_mode) {
-        // Only works in looping mode
-        x->phase = CLAMP(f, 0.0, 1.0);
-        reset_physics_state(x);  // Reset physics state for new phase position
-    } else {
-        post("physicslfo~: phase message only works in looping mode (send 'looping 1' first)");
+PHYSICSLFO_INLINE void physicslfo_ramp_advance(t_physicslfo_ramp *r, long n) {
+    if (r->remaining > 0) {
+        r->value = physicslfo_ramp_at(r, n);
+        r->remaining = n < r->remaining ? r->remaining - n : 0;
     }
 }
 
-//----------------------------------------------------------------------------------------------
+// Type selected by a float or signal value; last is the highest registered type
+#define PHYSICSLFO_TYPE_OF(value, last) ((long)CLAMP((value), 0.0, (double)(last)))
 
-void physicslfo_assist(t_physicslfo *x, void *b, long m, long a, char *s) {
-    if (m == ASSIST_INLET) {
-        switch (a) {
+// @morph: share of the next type in a fractional type value. Plugin types share
+// one state per voice, so blending stops at the last built-in type's neighbour.
+PHYSICSLFO_INLINE double physicslfo_type_blend(double value, long last) {
+    double clamped = CLAMP(value, 0.0, (double)last);
+    long type = (long)clamped;
+    
+    return type < PHYSICS_BUILTIN_TYPES ? clamped - type : 0.0;
+}
+
+// @morph with a type signal: 1 when some sample of the block sits between two
+// types, so blocks of whole values keep the single-type paths
+PHYSICSLFO_INLINE int physicslfo_type_morphing(t_physicslfo *x, const double *type_in, long sampleframes,
+                                               long last) {
+    long i;
+    
+    if (!x->morph) return 0;
+    for (i = 0; i < sampleframes; i++) {
+        if (physicslfo_type_blend(type_in[i], last) > 0.0) return 1;
+    }
+    return 0;
+}
+
+// @events: a new cycle (wrap or trigger edge) at sample i of the event buffer,
+// which is NULL without the event outlet
+#define PHYSICSLFO_EVENT_CYCLE(i) do { if (events) events[i] = PHYSICSLFO_EVENT_WRAP; } while (0)
+
+// Smoothed float frequency for sample i; a plain load of the target when no ramp runs
+#define PHYSICSLFO_FREQ_RAMP(i) CLAMP(physicslfo_ramp_at(&x->ramp_freq, (i) + 1), 0.0, PHYSICSLFO_FREQ_MAX)
+
+// Render loop for a single physics type. The *_sig flags are compile-time
+// constants in every perform variant, so the signal/float selection folds away.
+#define PHYSICSLFO_RENDER_LOOP(simulate) \
+    for (i = 0; i < sampleframes; i++) { \
+        double freq = freq_sig ? CLAMP(freq_in[i], 0.0, PHYSICSLFO_FREQ_MAX) : PHYSICSLFO_FREQ_RAMP(i); \
+        double physics_param = physics_sig ? CLAMP(physics_in[i], 0.0, 1.0) : physics_const; \
+        double damping = damping_sig ? CLAMP(damping_in[i], 0.0, 1.0) : damping_const; \
+        double elapsed = trigger_sig ? physicslfo_trigger_edge(v, trigger_in[i]) : 0.0; \
+        if (physicslfo_advance_phase(v, looping, &phase, freq * sr_inv, elapsed)) { \
+            reset_physics_state(v); \
+            PHYSICSLFO_EVENT_CYCLE(i); \
+        } \
+        if (physics_sig || damping_sig) \
+            physics_voice_coefs(v, physics_param, damping); \
+        value = simulate(v, phase, &v->coefs); \
+        out[i] = value; \
+    }
+
+// One segment of the block kernel path: decimated, or the active engine at full rate
+PHYSICSLFO_INLINE void physicslfo_render_kernel_segment(t_physicslfo *x, t_physics_voice *v, long type, double *buf,
+                                                        long n, double recursive_dt, int single, long decimate) {
+    if (decimate > 1) {
+        physics_decimated_render(v, type, buf, n, &v->coefs, decimate, x->interp_cubic);
+    } else {
+        physicslfo_render_segment(v, type, buf, n, &v->coefs, recursive_dt, single);
+    }
+}
+
+// @decimate factor for this block, or 1 when the anchors would be too sparse:
+// the fastest term of the curve needs PHYSICSLFO_DECIMATE_MIN_POINTS anchors per
+// period at the highest frequency reached in the block, or it would alias
+PHYSICSLFO_INLINE long physicslfo_decimate_factor(t_physicslfo *x, long type, const t_physics_coefs *coefs,
+                                                  const double *freq_in, long sampleframes, const int freq_sig) {
+    long factor = x->decimate;
+    double freq_max;
+    long i;
+    
+    if (factor <= 1) return 1;
+    
+    if (freq_sig) {
+        freq_max = 0.0;
+        for (i = 0; i < sampleframes; i++) {
+            if (freq_in[i] > freq_max) freq_max = freq_in[i];
+        }
+    } else {
+        freq_max = x->ramp_freq.value > x->ramp_freq.target ? x->ramp_freq.value : x->ramp_freq.target;
+    }
+    freq_max = CLAMP(freq_max, 0.0, PHYSICSLFO_FREQ_MAX) * physics_fastest_rate(type, coefs);
+    
+    if (freq_max * factor * PHYSICSLFO_DECIMATE_MIN_POINTS > x->sr) return 1;
+    return factor;
+}
+
+// Plugin types (physicslfo_plugin.h): the voice's plugin state is reset on the
+// first call after reset_physics_state or a type change, then the segment of
+// phases is rendered in place
+PHYSICSLFO_INLINE void physicslfo_plugin_render(t_physics_voice *v, long type, double *buf, long n,
+                                                const t_physics_coefs *coefs) {
+    const t_physicslfo_plugin *plugin = physicslfo_types[type].plugin;
+    
+    if (v->plugin_type != type) {
+        plugin->reset(v->plugin_state, coefs->param, coefs->damping);
+        v->plugin_type = type;
+    }
+    if (n > 0) {
+        plugin->render(v->plugin_state, buf, n, coefs->param, coefs->damping);
+    }
+}
+
+// One sample of a plugin type, for the per-sample loops
+PHYSICSLFO_INLINE double physicslfo_plugin_sample(t_physics_voice *v, long type, double t,
+                                                  const t_physics_coefs *coefs) {
+    double value = t;
+    
+    physicslfo_plugin_render(v, type, &value, 1, coefs);
+    return value;
+}
+
+// One sample of any registered type
+PHYSICSLFO_INLINE double physicslfo_type_sample(t_physics_voice *v, long type, double t,
+                                                const t_physics_coefs *coefs) {
+    return type < PHYSICS_BUILTIN_TYPES ? physics_simulate_at(v, type, t, coefs) :
+           physicslfo_plugin_sample(v, type, t, coefs);
+}
+
+// One sample of a type value under @morph: the lower type, blended toward the
+// next one by the fraction. Adjacent built-in types never both update the
+// collision state (only 0, 2 and 4 do), so one voice serves both.
+PHYSICSLFO_INLINE double physicslfo_morph_sample(t_physics_voice *v, double type_value, long last, double t,
+                                                 const t_physics_coefs *coefs) {
+    long type = PHYSICSLFO_TYPE_OF(type_value, last);
+    double blend = physicslfo_type_blend(type_value, last);
+    double value = physicslfo_type_sample(v, type, t, coefs);
+    
+    if (blend > 0.0) {
+        value += blend * (physicslfo_type_sample(v, type + 1, t, coefs) - value);
+    }
+    return value;
+}
+
+// @audiorate: the curve at t and its slope per unit of t on one side (side -1
+// looks back from t, +1 ahead). Evaluated on a copy, so the collision state of
+// the voice itself is left alone. It runs once per discontinuity, so it and the
+// helpers calling it are kept out of the specialized perform loops.
+static double physicslfo_audiorate_probe(const t_physics_voice *v, double type_value, int morph,
+                                         long last, double t, double side, double *slope) {
+    t_physics_voice probe = *v;
+    double step = side * PHYSICSLFO_AUDIORATE_PROBE;
+    double y, y2;
+    
+    if (morph) {
+        y = physicslfo_morph_sample(&probe, type_value, last, t, &probe.coefs);
+        probe = *v;
+        y2 = physicslfo_morph_sample(&probe, type_value, last, t + step, &probe.coefs);
+    } else {
+        long type = PHYSICSLFO_TYPE_OF(type_value, last);
+        
+        y = physicslfo_type_sample(&probe, type, t, &probe.coefs);
+        probe = *v;
+        y2 = physicslfo_type_sample(&probe, type, t + step, &probe.coefs);
+    }
+    *slope = (y2 - y) / step;
+    return y;
+}
+
+// @audiorate: step h and slope change m (per sample) of a discontinuity. The
+// curve ends at t_end on the voice before it and carries on from t_start on
+// the voice after it: two voices at a wrap or restart, the same one at a cusp.
+static void physicslfo_audiorate_step(const t_physics_voice *before, const t_physics_voice *after,
+                                      double type_value, int morph, long last, double t_end,
+                                      double t_start, double inc, double *h, double *m) {
+    double slope_end, slope_start;
+    double y_end = physicslfo_audiorate_probe(before, type_value, morph, last, t_end, -1.0, &slope_end);
+    double y_start = physicslfo_audiorate_probe(after, type_value, morph, last, t_start, 1.0, &slope_start);
+    
+    *h = y_start - y_end;
+    *m = (slope_start - slope_end) * inc;
+}
+
+// @audiorate: polyBLEP (step h) and polyBLAMP (slope change m) residuals of a
+// discontinuity d samples before sample i, 0 <= d < 1. The residual of sample
+// i - 1 at i = 0 belongs to the last block, which applied it when it saw the
+// discontinuity coming (physicslfo_audiorate_ahead).
+PHYSICSLFO_INLINE void physicslfo_audiorate_correct(double *out, long i, double d, double h, double m) {
+    double a = 1.0 - d;
+    
+    out[i] += a * a * (m * a * (1.0 / 6.0) - 0.5 * h);
+    if (i > 0) {
+        out[i - 1] += d * d * (0.5 * h + m * d * (1.0 / 6.0));
+    }
+}
+
+// @audiorate: the last segment boundary of type 4 (multi-bounce) after t0 and
+// up to t1, 0 when there is none. Its arcs meet the ground with a corner.
+PHYSICSLFO_INLINE double physicslfo_audiorate_cusp(const t_physics_coefs *coefs, double t0, double t1) {
+    double n = coefs->multibounce_per_cycle;
+    double k = floor(t1 * n);
+    
+    return (k > floor(t0 * n) && k > 0.0) ? k / n : 0.0;
+}
+
+// @audiorate at the end of a block: when the next sample, at the block's last
+// increment, crosses a wrap, an envelope end or a cusp, add the residual of the
+// sample before it now. The next block adds the rest once it gets there.
+static void physicslfo_audiorate_ahead(t_physics_voice *v, long type, double type_value, int morph,
+                                       long last, long looping, double phase, double inc, double *out,
+                                       long sampleframes) {
+    double next = phase + inc;
+    double h, m, d;
+    
+    if (sampleframes < 1 || inc <= 0.0) return;
+    
+    if (looping && next >= 1.0) {
+        t_physics_voice start = *v;
+        
+        reset_physics_state(&start);    // Draws the same @jitter values as the wrap will
+        physicslfo_audiorate_step(v, &start, type_value, morph, last, 1.0, 0.0, inc, &h, &m);
+        d = (next - 1.0) / inc;
+    } else if (!looping && phase < 1.0 && next >= 1.0) {
+        physicslfo_audiorate_step(v, v, type_value, morph, last, 1.0, 1.0, inc, &h, &m);
+        d = (next - 1.0) / inc;
+    } else {
+        double cusp = type == 4 ? physicslfo_audiorate_cusp(&v->coefs, phase, next) : 0.0;
+        
+        if (cusp <= 0.0) return;
+        physicslfo_audiorate_step(v, v, type_value, morph, last, cusp, cusp, inc, &h, &m);
+        h = 0.0;
+        d = (next - cusp) / inc;
+    }
+    d = CLAMP(d, 0.0, 1.0);
+    out[sampleframes - 1] += d * d * (0.5 * h + m * d * (1.0 / 6.0));
+}
+
+// @jitter amounts for a voice
+void physicslfo_jitter_setup(t_physics_voice *v, const double *jitter) {
+    long on = 0;
+    
+    for (long i = 0; i < PHYSICS_JITTER_AMOUNTS; i++) {
+        v->jitter[i] = jitter[i];
+        on |= jitter[i] > 0.0;
+    }
+    if (!on) {
+        // Back to the plain controls from the next coefficient update
+        v->param_offset = 0.0;
+        v->damping_offset = 0.0;
+    }
+    v->jitter_on = on;
+}
+
+// Per block: the snapshot's @jitter, and a fresh stream after every @seed.
+// Voice i of every instance with the same seed replays the same variation.
+PHYSICSLFO_INLINE void physicslfo_jitter_voice(t_physicslfo *x, t_physics_voice *v, long index) {
+    if (v->jitter_epoch != x->params.jitter_epoch) {
+        v->jitter_epoch = x->params.jitter_epoch;
+        v->jitter_key = physics_random((uint64_t)x->params.jitter_seed, (uint64_t)index);
+        v->jitter_draws = 0;
+    }
+    physicslfo_jitter_setup(v, x->params.jitter);
+}
+
+// @sync in looping mode: every block restarts from the transport position,
+// one increment early since the loop advances before each sample. A jump
+// that isn't the current cycle carrying on (locate, loop) resets the physics.
+PHYSICSLFO_INLINE void physicslfo_sync_anchor(t_physicslfo *x, t_physics_voice *v, long looping,
+                                              double freq_const) {
+    if (x->sync_active && looping) {
+        double anchor = x->sync_phase - freq_const * x->sr_inv;
+        double jump;
+        
+        anchor -= floor(anchor);
+        jump = anchor - v->phase;
+        jump -= floor(jump + 0.5);
+        if (fabs(jump) > PHYSICSLFO_SYNC_JUMP) {
+            reset_physics_state(v);
+        }
+        physics_voice_set_phase(v, anchor);
+    }
+}
+
+// @events: ground contacts in a rendered block of one voice, never replacing a
+// cycle mark. Bounce and spin land where the curve comes down to 0, multi-bounce
+// at the low point between two of its arcs (a minimum at the end of the last
+// block is reported at sample 0). Other types have no collisions.
+PHYSICSLFO_INLINE void physicslfo_event_collisions(t_physics_voice *v, long type, const double *out,
+                                                   double *events, long sampleframes) {
+    double prev = v->event_prev[0];
+    double prev2 = v->event_prev[1];
+    long i;
+    
+    if (type != 0 && type != 2 && type != 4) return;
+    
+    for (i = 0; i < sampleframes; i++) {
+        double cur = out[i];
+        int contact = type == 4 ? (prev < prev2 && prev <= cur) : (cur <= 0.0 && prev > 0.0);
+        long at = (type == 4 && i > 0) ? i - 1 : i;
+        
+        if (contact && events[at] == 0.0) events[at] = PHYSICSLFO_EVENT_COLLISION;
+        prev2 = prev;
+        prev = cur;
+    }
+    v->event_prev[0] = prev;
+    v->event_prev[1] = prev2;
+}
+
+PHYSICSLFO_INLINE void physicslfo_perform_voice(t_physicslfo *x, t_physics_voice *v,
+                                                const double *freq_in, const double *type_in,
+                                                const double *physics_in, const double *damping_in,
+                                                const double *trigger_in, double *out, double *events,
+                                                long sampleframes,
+                                                const int freq_sig, const int type_sig,
+                                                const int physics_sig, const int damping_sig,
+                                                const int trigger_sig) {
+    // Float physics and damping are fixed for the whole block; while @smooth
+    // ramps them they step once per block, to the value reached at block end
+    double freq_const = CLAMP(x->ramp_freq.target, 0.0, PHYSICSLFO_FREQ_MAX);
+    double physics_const = CLAMP(physicslfo_ramp_at(&x->ramp_physics, sampleframes), 0.0, 1.0);
+    double damping_const = CLAMP(physicslfo_ramp_at(&x->ramp_damping, sampleframes), 0.0, 1.0);
+    int ramping = x->ramp_physics.remaining > 0 || x->ramp_damping.remaining > 0;
+    
+    long looping = x->params.looping;
+    const t_physics_table *table = PHYSICSLFO_LOAD_ACQUIRE_PTR(&x->table);  // Retired only after this block
+    
+    // @accum changes are picked up here, so the counter starts from the phase
+    // the audio thread actually has
+    physics_voice_phase_fixed(v, x->accum_fixed);
+    
+    physicslfo_jitter_voice(x, v, v - x->voices);
+    physicslfo_sync_anchor(x, v, looping, freq_const);
+    
+    // Event outlet: zero except for the marks of this block, starting with a
+    // bang taken from the message side
+    if (events) {
+        memset(events, 0, sampleframes * sizeof(double));
+        if (v->event_restart && sampleframes > 0) events[0] = PHYSICSLFO_EVENT_WRAP;
+    }
+    v->event_restart = 0;
+    
+    double phase = v->phase;
+    double sr_inv = x->sr_inv;
+    double value = v->last_value;
+    long i;
+    
+    // Type fast path: float type inlet, or a type signal that holds one value for the block
+    long type_last = (long)PHYSICSLFO_LOAD_ACQUIRE(&physicslfo_type_count) - 1;
+    long type = PHYSICSLFO_TYPE_OF(type_sig ? type_in[0] : x->params.type, type_last);
+    int type_constant = 1;
+    
+    // Float physics/damping: constants are rebuilt at most once per block. With
+    // either one as a signal they are refreshed per sample, whenever it moves.
+    if (!physics_sig && !damping_sig) {
+        physics_voice_coefs(v, physics_const, damping_const);
+    }
+    
+    if (type_sig) {
+        for (i = 1; i < sampleframes; i++) {
+            if (PHYSICSLFO_TYPE_OF(type_in[i], type_last) != type) {
+                type_constant = 0;
+                break;
+            }
+        }
+    }
+    int morph = type_sig && physicslfo_type_morphing(x, type_in, sampleframes, type_last);
+    
+    if (morph) type_constant = 0;
+    
+    // Envelope finished and settled: constant fill, only the phase (and any
+    // trigger edge) is tracked. Float physics/damping keep the value fixed. The
+    // fixed-point counter saturates here instead: the curve no longer depends
+    // on t, so the time since the envelope stops growing.
+    double rest = 0.0;
+    int settled = !looping && !v->envelope_active && !type_sig && !physics_sig && !damping_sig && !ramping &&
+                  type < PHYSICS_BUILTIN_TYPES && physics_settled(v, type, phase, &v->coefs, &rest);
+    
+    if (settled && trigger_sig) {
+        double prev = v->trigger_prev;
+        
+        for (i = 0; i < sampleframes && settled; i++) {
+            if (prev <= 0.0 && trigger_in[i] > 0.0) settled = 0;
+            prev = trigger_in[i];
+        }
+    }
+    v->idle = settled;
+    
+    // Decimation runs on the block kernel path, so it needs the same steady inputs
+    long decimate = (type_constant && !physics_sig && !damping_sig && type < PHYSICS_BUILTIN_TYPES) ?
+                    physicslfo_decimate_factor(x, type, &v->coefs, freq_in, sampleframes, freq_sig) : 1;
+    
+    if (settled) {
+        // The phase keeps running at the rate the active path would use
+        double freq_cap = x->audiorate ? MIN(PHYSICSLFO_AUDIORATE_FREQ_MAX, 0.5 * x->sr) : PHYSICSLFO_FREQ_MAX;
+        
+        for (i = 0; i < sampleframes; i++) {
+            if (!v->phase_fixed_on) {
+                double freq = freq_sig ? freq_in[i] : physicslfo_ramp_at(&x->ramp_freq, i + 1);
+                
+                phase += CLAMP(freq, 0.0, freq_cap) * sr_inv;
+            }
+            out[i] = rest;
+        }
+        if (trigger_sig && sampleframes > 0) {
+            v->trigger_prev = trigger_in[sampleframes - 1];
+        }
+        physics_settled_advance(v, type, sampleframes, &v->coefs);
+        value = rest;
+    } else if (x->audiorate) {
+        // Audio-rate mode: per sample up to the audio-rate cap. Wraps, trigger
+        // restarts, the end of an envelope and the corners between multi-bounce
+        // arcs get polyBLEP/polyBLAMP residuals at their exact positions.
+        double freq_cap = MIN(PHYSICSLFO_AUDIORATE_FREQ_MAX, 0.5 * x->sr);
+        double inc = 0.0;
+        double type_value = type;
+        long sample_type = type;
+        
+        for (i = 0; i < sampleframes; i++) {
+            double freq = freq_sig ? freq_in[i] : physicslfo_ramp_at(&x->ramp_freq, i + 1);
+            double elapsed = trigger_sig ? physicslfo_trigger_edge(v, trigger_in[i]) : 0.0;
+            double physics_param = physics_sig ? CLAMP(physics_in[i], 0.0, 1.0) : physics_const;
+            double damping = damping_sig ? CLAMP(damping_in[i], 0.0, 1.0) : damping_const;
+            double t0 = phase;
+            t_physics_voice end;
+            int restart;
+            
+            inc = CLAMP(freq, 0.0, freq_cap) * sr_inv;
+            if (type_sig) {
+                type_value = type_in[i];
+                sample_type = PHYSICSLFO_TYPE_OF(type_value, type_last);
+            }
+            
+            restart = physicslfo_advance_phase(v, looping, &phase, inc, elapsed);
+            if (restart) {
+                end = *v;
+                reset_physics_state(v);
+                PHYSICSLFO_EVENT_CYCLE(i);
+            }
+            if (physics_sig || damping_sig)
+                physics_voice_coefs(v, physics_param, damping);
+            
+            value = morph ? physicslfo_morph_sample(v, type_value, type_last, phase, &v->coefs) :
+                    physicslfo_type_sample(v, sample_type, phase, &v->coefs);
+            out[i] = value;
+            
+            if (inc > 0.0) {
+                double h, m, cusp;
+                
+                if (restart) {
+                    double d = CLAMP(phase / inc, 0.0, 1.0);
+                    double t_end = elapsed > 0.0 ? t0 + inc * (1.0 - d) : 1.0;
+                    
+                    physicslfo_audiorate_step(&end, v, type_value, morph, type_last, t_end, 0.0, inc, &h, &m);
+                    physicslfo_audiorate_correct(out, i, d, h, m);
+                } else if (!looping && t0 < 1.0 && phase >= 1.0) {
+                    physicslfo_audiorate_step(v, v, type_value, morph, type_last, 1.0, 1.0, inc, &h, &m);
+                    physicslfo_audiorate_correct(out, i, CLAMP((phase - 1.0) / inc, 0.0, 1.0), h, m);
+                } else if (sample_type == 4 &&
+                           (cusp = physicslfo_audiorate_cusp(&v->coefs, t0, phase)) > 0.0) {
+                    physicslfo_audiorate_step(v, v, type_value, morph, type_last, cusp, cusp, inc, &h, &m);
+                    physicslfo_audiorate_correct(out, i, CLAMP((phase - cusp) / inc, 0.0, 1.0), 0.0, m);
+                }
+            }
+        }
+        physicslfo_audiorate_ahead(v, sample_type, type_value, morph, type_last, looping, phase, inc, out,
+                                   sampleframes);
+        if (sampleframes > 0) {
+            value = out[sampleframes - 1];
+        }
+    } else if (type_constant && type >= PHYSICS_BUILTIN_TYPES) {
+        // Plugin type: the same phase pass as the block kernel path, with one
+        // plugin call per segment between wraps, or per sample while physics
+        // or damping is a signal
+        long segment = 0;
+        
+        for (i = 0; i < sampleframes; i++) {
+            double freq = freq_sig ? CLAMP(freq_in[i], 0.0, PHYSICSLFO_FREQ_MAX) : PHYSICSLFO_FREQ_RAMP(i);
+            double elapsed = trigger_sig ? physicslfo_trigger_edge(v, trigger_in[i]) : 0.0;
+            
+            if (physics_sig || damping_sig) {
+                double physics_param = physics_sig ? CLAMP(physics_in[i], 0.0, 1.0) : physics_const;
+                double damping = damping_sig ? CLAMP(damping_in[i], 0.0, 1.0) : damping_const;
+                
+                if (physicslfo_advance_phase(v, looping, &phase, freq * sr_inv, elapsed)) {
+                    reset_physics_state(v);
+                    PHYSICSLFO_EVENT_CYCLE(i);
+                }
+                physics_voice_coefs(v, physics_param, damping);
+                out[i] = physicslfo_plugin_sample(v, type, phase, &v->coefs);
+            } else {
+                if (physicslfo_advance_phase(v, looping, &phase, freq * sr_inv, elapsed)) {
+                    physicslfo_plugin_render(v, type, out + segment, i - segment, &v->coefs);
+                    reset_physics_state(v);
+                    PHYSICSLFO_EVENT_CYCLE(i);
+                    segment = i;
+                }
+                out[i] = phase;
+            }
+        }
+        if (!physics_sig && !damping_sig) {
+            physicslfo_plugin_render(v, type, out + segment, sampleframes - segment, &v->coefs);
+        }
+        
+        if (sampleframes > 0) {
+            value = out[sampleframes - 1];
+        }
+    } else if (table && looping && !ramping && !type_sig && !physics_sig && !damping_sig && !v->jitter_on) {
+        // Wavetable path: the cycle is fully determined by the float parameters,
+        // so play the shared table with linear interpolation
+        const double *data = table->data;
+        long size = table->size;
+        
+        for (i = 0; i < sampleframes; i++) {
+            double freq = freq_sig ? CLAMP(freq_in[i], 0.0, PHYSICSLFO_FREQ_MAX) : PHYSICSLFO_FREQ_RAMP(i);
+            double elapsed = trigger_sig ? physicslfo_trigger_edge(v, trigger_in[i]) : 0.0;
+            
+            if (physicslfo_advance_phase(v, looping, &phase, freq * sr_inv, elapsed)) {
+                reset_physics_state(v);
+                PHYSICSLFO_EVENT_CYCLE(i);
+            }
+            value = physics_table_read(data, size, phase);
+            out[i] = value;
+        }
+    } else if (type_constant && !physics_sig && !damping_sig && !freq_sig && !trigger_sig &&
+               x->ramp_freq.remaining == 0 && decimate == 1 && !events) {
+        // Everything steady for the block: the core's block render API, which
+        // wraps internally, so not with the event outlet
+        v->phase = phase;
+        physics_voice_render(v, type, out, sampleframes, physics_const, damping_const, freq_const * sr_inv,
+                             looping, (x->engine_recursive ? PHYSICS_RENDER_RECURSIVE : 0) |
+                                      (x->precision_single ? PHYSICS_RENDER_SINGLE : 0));
+        phase = v->phase;
+        value = v->last_value;
+    } else if (type_constant && !physics_sig && !damping_sig) {
+        // Block kernel path: write the phase of every sample into the output
+        // buffer, then the vectorized kernel turns it into physics values in place.
+        // A cycle wrap resets the physics state, so the segment before it is
+        // rendered first. The recursive engine needs a constant phase increment,
+        // so a frequency signal or frequency ramp takes the closed form. With
+        // @decimate the segments are evaluated at anchors and interpolated.
+        int freq_steady = !freq_sig && x->ramp_freq.remaining == 0;
+        double recursive_dt = (x->engine_recursive && freq_steady) ?
+                              physics_phase_increment(v, freq_const * sr_inv) : 0.0;
+        int single = x->precision_single != 0;
+        long segment = 0;
+        
+        for (i = 0; i < sampleframes; i++) {
+            double freq = freq_sig ? CLAMP(freq_in[i], 0.0, PHYSICSLFO_FREQ_MAX) : PHYSICSLFO_FREQ_RAMP(i);
+            double elapsed = trigger_sig ? physicslfo_trigger_edge(v, trigger_in[i]) : 0.0;
+            
+            if (physicslfo_advance_phase(v, looping, &phase, freq * sr_inv, elapsed)) {
+                physicslfo_render_kernel_segment(x, v, type, out + segment, i - segment, recursive_dt, single,
+                                                 decimate);
+                reset_physics_state(v);
+                PHYSICSLFO_EVENT_CYCLE(i);
+                segment = i;
+            }
+            out[i] = phase;
+        }
+        physicslfo_render_kernel_segment(x, v, type, out + segment, sampleframes - segment, recursive_dt, single,
+                                         decimate);
+        
+        if (sampleframes > 0) {
+            value = out[sampleframes - 1];
+        }
+    } else if (type_constant) {
+        switch (type) {
+            case 0:  // Bounce
+                PHYSICSLFO_RENDER_LOOP(simulate_bounce)
+                break;
+            case 1:  // Elastic
+                PHYSICSLFO_RENDER_LOOP(simulate_elastic)
+                break;
+            case 2:  // Bounce with spin
+                PHYSICSLFO_RENDER_LOOP(simulate_bounce_spin)
+                break;
+            case 3:  // Elastic overshoot
+                PHYSICSLFO_RENDER_LOOP(simulate_elastic_overshoot)
+                break;
+            case 4:  // Multi-bounce
+                PHYSICSLFO_RENDER_LOOP(simulate_multibounce)
+                break;
+            case 5:  // Wobble
+                PHYSICSLFO_RENDER_LOOP(simulate_wobble)
+                break;
+        }
+    } else if (morph) {
+        // Fractional type: the two adjacent types per sample
+        for (i = 0; i < sampleframes; i++) {
+            double freq = freq_sig ? CLAMP(freq_in[i], 0.0, PHYSICSLFO_FREQ_MAX) : PHYSICSLFO_FREQ_RAMP(i);
+            double elapsed = trigger_sig ? physicslfo_trigger_edge(v, trigger_in[i]) : 0.0;
+            double physics_param = physics_sig ? CLAMP(physics_in[i], 0.0, 1.0) : physics_const;
+            double damping = damping_sig ? CLAMP(damping_in[i], 0.0, 1.0) : damping_const;
+            
+            if (physicslfo_advance_phase(v, looping, &phase, freq * sr_inv, elapsed)) {
+                reset_physics_state(v);
+                PHYSICSLFO_EVENT_CYCLE(i);
+            }
+            if (physics_sig || damping_sig)
+                physics_voice_coefs(v, physics_param, damping);
+            
+            value = physicslfo_morph_sample(v, type_in[i], type_last, phase, &v->coefs);
+            out[i] = value;
+        }
+    } else {
+        // Type modulated within the block: per-sample dispatch
+        for (i = 0; i < sampleframes; i++) {
+            double freq = freq_sig ? CLAMP(freq_in[i], 0.0, PHYSICSLFO_FREQ_MAX) : PHYSICSLFO_FREQ_RAMP(i);
+            double elapsed = trigger_sig ? physicslfo_trigger_edge(v, trigger_in[i]) : 0.0;
+            double physics_param = physics_sig ? CLAMP(physics_in[i], 0.0, 1.0) : physics_const;
+            double damping = damping_sig ? CLAMP(damping_in[i], 0.0, 1.0) : damping_const;
+            long sample_type = PHYSICSLFO_TYPE_OF(type_in[i], type_last);
+            
+            if (physicslfo_advance_phase(v, looping, &phase, freq * sr_inv, elapsed)) {
+                reset_physics_state(v);
+                PHYSICSLFO_EVENT_CYCLE(i);
+            }
+            if (physics_sig || damping_sig)
+                physics_voice_coefs(v, physics_param, damping);
+            
+            switch (sample_type) {
+                case 0:  value = simulate_bounce(v, phase, &v->coefs); break;
+                case 1:  value = simulate_elastic(v, phase, &v->coefs); break;
+                case 2:  value = simulate_bounce_spin(v, phase, &v->coefs); break;
+                case 3:  value = simulate_elastic_overshoot(v, phase, &v->coefs); break;
+                case 4:  value = simulate_multibounce(v, phase, &v->coefs); break;
+                case 5:  value = simulate_wobble(v, phase, &v->coefs); break;
+                default: value = physicslfo_plugin_sample(v, sample_type, phase, &v->coefs); break;
+            }
+            
+            // Output unipolar range (0 to 1) - natural for physics simulations
+            out[i] = value;
+        }
+    }
+    
+    if (events) {
+        physicslfo_event_collisions(v, type, out, events, sampleframes);
+    }
+    
+    // Store for next block
+    v->last_value = value;
+    v->phase = phase;
+}
+
+// Transport read for @sync (audio thread): the phase of the block's first
+// sample and the transport's rate, which replaces the frequency ramp for the
+// block. Returns 0 (and leaves the ramp alone) when sync is off.
+PHYSICSLFO_INLINE long physicslfo_sync_block(t_physicslfo *x) {
+    t_itm *itm = PHYSICSLFO_LOAD_ACQUIRE_PTR(&x->sync_itm);  // Retired only after sync_reads moves on
+    double period = x->params.sync_notes;
+    
+    x->sync_active = 0;
+    if (itm) {
+        if (x->params.sync_bars > 0.0) {
+            long num = 4, denom = 4;
+            
+            itm_gettimesignature(itm, &num, &denom);
+            period = x->params.sync_bars * num * PHYSICSLFO_SYNC_TICKS_PER_WHOLE / (denom > 0 ? denom : 4);
+        }
+        if (period > 0.0) {
+            double cycles = itm_getticks(itm) / period;
+            double rate = itm_getstate(itm) ? itm_mstoticks(itm, 1000.0) / period : 0.0;  // Cycles per second
+            
+            x->sync_phase = cycles - floor(cycles);
+            physicslfo_ramp_init(&x->ramp_freq, rate);
+            x->sync_active = 1;
+        }
+    }
+    
+    // Done with itm: a transport replaced before this point is no longer in use
+    PHYSICSLFO_STORE_RELEASE(&x->sync_reads, x->sync_reads + 1);
+    return x->sync_active;
+}
+
+// @oversample: 1 when the block needs the higher rate, that is when the first
+// PHYSICSLFO_OVERSAMPLE_HARMONICS harmonics of the curve's fastest term would
+// not all fit below Nyquist at the block's highest frequency. The term's rate
+// only grows with the physics parameter, so the block's largest one is used.
+static int physicslfo_oversample_needed(t_physicslfo *x, const double *freq_in, const double *type_in,
+                                        const double *physics_in, long sampleframes, int freq_sig, int type_sig,
+                                        int physics_sig) {
+    double freq_cap = x->audiorate ? MIN(PHYSICSLFO_AUDIORATE_FREQ_MAX, 0.5 * x->sr * x->os_factor) :
+                      PHYSICSLFO_FREQ_MAX;
+    long type_last = (long)PHYSICSLFO_LOAD_ACQUIRE(&physicslfo_type_count) - 1;
+    double freq_max, physics_max, rate = 0.0;
+    t_physics_coefs coefs;
+    long type = -1;
+    long i;
+    
+    if (freq_sig) {
+        freq_max = 0.0;
+        for (i = 0; i < sampleframes; i++) {
+            if (freq_in[i] > freq_max) freq_max = freq_in[i];
+        }
+    } else {
+        freq_max = MAX(x->ramp_freq.value, x->ramp_freq.target);
+    }
+    if (physics_sig) {
+        physics_max = 0.0;
+        for (i = 0; i < sampleframes; i++) {
+            if (physics_in[i] > physics_max) physics_max = physics_in[i];
+        }
+    } else {
+        physics_max = MAX(x->ramp_physics.value, x->ramp_physics.target);
+    }
+    physics_coefs_build(&coefs, CLAMP(physics_max, 0.0, 1.0), 0.0);
+    
+    // Every type the block visits, and the next one of each while @morph may blend toward it
+    for (i = 0; i < (type_sig ? sampleframes : 1); i++) {
+        long sample_type = PHYSICSLFO_TYPE_OF(type_sig ? type_in[i] : x->params.type, type_last);
+        
+        if (sample_type != type) {
+            type = sample_type;
+            rate = MAX(rate, physics_fastest_rate(type, &coefs));
+            if (x->morph && type < type_last) {
+                rate = MAX(rate, physics_fastest_rate(type + 1, &coefs));
+            }
+        }
+    }
+    
+    return CLAMP(freq_max, 0.0, freq_cap) * rate * PHYSICSLFO_OVERSAMPLE_HARMONICS > 0.5 * x->sr;
+}
+
+// Run n samples of buf through a voice's ring: each sample goes in, and the
+// one written delay samples earlier comes out in its place
+PHYSICSLFO_INLINE void physicslfo_oversample_delay(double *ring, unsigned long pos, double *buf, long n,
+                                                   long delay) {
+    long i;
+    
+    for (i = 0; i < n; i++) {
+        double in = buf[i];
+        
+        ring[(pos + i) & (PHYSICSLFO_OVERSAMPLE_RING - 1)] = in;
+        buf[i] = ring[(pos + i - delay) & (PHYSICSLFO_OVERSAMPLE_RING - 1)];
+    }
+}
+
+// @oversample on a block rendered at the sample rate: delayed by the
+// decimator's latency, so the output doesn't jump when the rate switches
+PHYSICSLFO_INLINE void physicslfo_oversample_bypass(t_physicslfo *x, t_physicslfo_oversampler *os, double *out,
+                                                    double *events, long sampleframes) {
+    physicslfo_oversample_delay(os->ring, os->ring_pos, out, sampleframes, x->os_delay);
+    if (events) {
+        physicslfo_oversample_delay(os->event_ring, os->ring_pos, events, sampleframes, x->os_delay);
+    }
+    os->ring_pos += sampleframes;
+    os->active = 0;
+}
+
+// A voice coming back to oversampling: every decimator stage's history is
+// filled with the base-rate output it would have seen, interpolated between
+// base samples, each stage's input lagging by the delay of the stages before it
+static void physicslfo_oversample_resume(t_physicslfo *x, t_physicslfo_oversampler *os) {
+    long rate = x->os_factor;   // Input rate of the stage, in samples per base sample
+    long lag = 0;               // Delay of the stages before it, in base samples
+    long stage = 0;
+    long i;
+    
+    for (; rate > 1; rate /= 2, stage++) {
+        long taps = rate == 2 ? PHYSICSLFO_OVERSAMPLE_TAPS : PHYSICSLFO_OVERSAMPLE_TAPS_EARLY;
+        long h = PHYSICS_HALFBAND_HISTORY(taps);
+        
+        for (i = 0; i < h; i++) {
+            long back = (h - 1 - i) / rate + lag;
+            double frac = (double)((h - 1 - i) % rate) / rate;
+            double newer = os->ring[(os->ring_pos - 1 - back) & (PHYSICSLFO_OVERSAMPLE_RING - 1)];
+            double older = os->ring[(os->ring_pos - 2 - back) & (PHYSICSLFO_OVERSAMPLE_RING - 1)];
+            
+            os->history[stage][i] = newer + frac * (older - newer);
+        }
+        lag += 2 * taps / rate;
+    }
+    os->active = 1;
+}
+
+PHYSICSLFO_INLINE void physicslfo_ramp_scale(t_physicslfo_ramp *r, long factor) {
+    r->step /= factor;
+    r->remaining *= factor;
+}
+
+// @oversample on a block that needs it: the voice renders factor samples per
+// output sample, with the signal inputs held over each group and the sample
+// rate and ramps scaled to match, then the half-band stages take it back
+// down. This one variant serves every connection pattern, with the patterns
+// tested per sample, so the specialized routines stay as they were.
+static void physicslfo_perform_oversampled(t_physicslfo *x, t_physics_voice *v, t_physicslfo_oversampler *os,
+                                           const double **ins, double *out, double *events, long sampleframes,
+                                           int freq_sig, int type_sig, int physics_sig, int damping_sig,
+                                           int trigger_sig) {
+    const int sig[PHYSICSLFO_NUM_INLETS] = { freq_sig, type_sig, physics_sig, damping_sig, trigger_sig };
+    const double *held[PHYSICSLFO_NUM_INLETS];
+    long factor = x->os_factor;
+    long n = sampleframes * factor;
+    double sr = x->sr;
+    double sr_inv = x->sr_inv;
+    t_physicslfo_ramp ramp_freq = x->ramp_freq;
+    t_physicslfo_ramp ramp_physics = x->ramp_physics;
+    t_physicslfo_ramp ramp_damping = x->ramp_damping;
+    double *buf = x->os_buffer;
+    long i, j, k;
+    
+    for (j = 0; j < PHYSICSLFO_NUM_INLETS; j++) {
+        held[j] = ins[j];
+        if (sig[j]) {
+            double *in = x->os_inputs + j * x->os_vectorsize * factor;
+            
+            for (i = 0; i < sampleframes; i++) {
+                for (k = 0; k < factor; k++) {
+                    in[i * factor + k] = ins[j][i];
+                }
+            }
+            held[j] = in;
+        }
+    }
+    if (!os->active) {
+        physicslfo_oversample_resume(x, os);
+    }
+    
+    x->sr = sr * factor;
+    x->sr_inv = sr_inv / factor;
+    physicslfo_ramp_scale(&x->ramp_freq, factor);
+    physicslfo_ramp_scale(&x->ramp_physics, factor);
+    physicslfo_ramp_scale(&x->ramp_damping, factor);
+    
+    physicslfo_perform_voice(x, v, held[0], held[1], held[2], held[3], held[4], buf, events ? x->os_events : NULL,
+                             n, freq_sig, type_sig, physics_sig, damping_sig, trigger_sig);
+    
+    x->sr = sr;
+    x->sr_inv = sr_inv;
+    x->ramp_freq = ramp_freq;
+    x->ramp_physics = ramp_physics;
+    x->ramp_damping = ramp_damping;
+    
+    // The ring keeps the value at each base sample (the last of its group)
+    for (i = 0; i < sampleframes; i++) {
+        os->ring[(os->ring_pos + i) & (PHYSICSLFO_OVERSAMPLE_RING - 1)] = buf[i * factor + factor - 1];
+    }
+    
+    // factor 8 -> 4 -> 2 with the short kernel, 2 -> 1 with the long one
+    for (k = 0; n > sampleframes; k++, n /= 2) {
+        if (n == 2 * sampleframes) {
+            physics_halfband_decimate(x->os_kernel, PHYSICSLFO_OVERSAMPLE_TAPS, os->history[k], buf, n, x->os_work);
+        } else {
+            physics_halfband_decimate(x->os_kernel_early, PHYSICSLFO_OVERSAMPLE_TAPS_EARLY, os->history[k], buf, n,
+                                      x->os_work);
+        }
+    }
+    memcpy(out, buf, sampleframes * sizeof(double));
+    
+    // Events keep their base sample, delayed like the output
+    if (events) {
+        for (i = 0; i < sampleframes; i++) {
+            double mark = 0.0;
+            
+            for (k = 0; k < factor; k++) {
+                mark = MAX(mark, x->os_events[i * factor + k]);
+            }
+            events[i] = mark;
+        }
+        physicslfo_oversample_delay(os->event_ring, os->ring_pos, events, sampleframes, x->os_delay);
+    }
+    os->ring_pos += sampleframes;
+}
+
+// Run every voice through the specialized loop. Voice i reads channel
+// (i % channels) of each inlet, so a single-channel input drives all voices and
+// an mc input with one channel per voice drives each voice separately.
+PHYSICSLFO_INLINE void physicslfo_perform_voices(t_physicslfo *x, double **ins, double **outs, long numouts,
+                                                 long voices, long sampleframes, const int freq_sig, const int type_sig,
+                                                 const int physics_sig, const int damping_sig,
+                                                 const int trigger_sig) {
+    long events = x->events && numouts >= 2 * x->chans;   // Event channels follow the LFO channels
+    long i, j;
+    
+    for (i = 0; i < voices; i++) {
+        const double *in[PHYSICSLFO_NUM_INLETS];
+        double *event_out = events ? outs[x->chans + i] : NULL;
+        
+        for (j = 0; j < PHYSICSLFO_NUM_INLETS; j++) {
+            in[j] = ins[x->inlet_offset[j] + i % x->inlet_chans[j]];
+        }
+        
+        // @oversample: the higher rate only for blocks that need it, the rest
+        // delayed to line up with the decimated ones
+        if (x->os_factor > 1 && sampleframes <= x->os_vectorsize &&
+            physicslfo_oversample_needed(x, in[0], in[1], in[2], sampleframes, freq_sig, type_sig, physics_sig)) {
+            physicslfo_perform_oversampled(x, x->voices + i, x->os_state + i, in, outs[i], event_out, sampleframes,
+                                           freq_sig, type_sig, physics_sig, damping_sig, trigger_sig);
+            continue;
+        }
+        physicslfo_perform_voice(x, x->voices + i, in[0], in[1], in[2], in[3], in[4], outs[i], event_out,
+                                 sampleframes, freq_sig, type_sig, physics_sig, damping_sig, trigger_sig);
+        if (x->os_factor > 1) {
+            physicslfo_oversample_bypass(x, x->os_state + i, outs[i], event_out, sampleframes);
+        }
+    }
+}
+
+// Phase of one tap, lagging the shared phase by offset cycles. Returns 1 when
+// the tap's collision state starts over: at its own wrap, or when the shared
+// phase was restarted by a trigger edge (stored as -phase - 1).
+PHYSICSLFO_INLINE int physicslfo_tap_phase(const t_physics_voice *tap, double shared, double offset, long looping,
+                                           double *t) {
+    int restart = shared < 0.0;
+    double lagged = (restart ? -shared - 1.0 : shared) - offset;
+    
+    if (looping) {
+        lagged -= floor(lagged);
+        if (lagged >= 1.0) lagged = 0.0;    // Rounding of a tiny negative lag
+        restart |= lagged < tap->phase;
+    } else if (lagged < 0.0) {
+        lagged = 0.0;                       // Envelope not reached this tap yet
+    }
+    *t = lagged;
+    return restart;
+}
+
+// One wrap-free segment of tap phases, built-in kernels or a plugin type
+PHYSICSLFO_INLINE void physicslfo_tap_segment(t_physics_voice *tap, long type, double *buf, long n,
+                                              const t_physics_coefs *coefs, int single) {
+    if (type < PHYSICS_BUILTIN_TYPES) {
+        physicslfo_render_segment(tap, type, buf, n, coefs, 0.0, single);
+    } else {
+        physicslfo_plugin_render(tap, type, buf, n, coefs);
+    }
+}
+
+// @taps: one phase accumulator (voices[0]) and one set of per-cycle constants
+// drive every tap. Each tap reads the shape @offsets cycles behind the shared
+// phase, with its own collision state (voices[1..taps]), whose phase field
+// holds the tap's last t. The shared phase of the block is written to the last
+// outlet first, which that tap then overwrites with its values. The event
+// outlet (@events) carries the starts of the shared cycle.
+PHYSICSLFO_INLINE void physicslfo_perform_taps(t_physicslfo *x, double **ins, double **outs, long numouts,
+                                               long sampleframes, const int freq_sig, const int type_sig,
+                                               const int physics_sig, const int damping_sig,
+                                               const int trigger_sig) {
+    const double *freq_in = ins[x->inlet_offset[0]];
+    const double *type_in = ins[x->inlet_offset[1]];
+    const double *physics_in = ins[x->inlet_offset[2]];
+    const double *damping_in = ins[x->inlet_offset[3]];
+    const double *trigger_in = ins[x->inlet_offset[4]];
+    t_physics_voice *v = x->voices;
+    long taps = MIN(x->taps, numouts);
+    
+    if (taps < 1) return;
+    
+    double freq_const = CLAMP(x->ramp_freq.target, 0.0, PHYSICSLFO_FREQ_MAX);
+    double physics_const = CLAMP(physicslfo_ramp_at(&x->ramp_physics, sampleframes), 0.0, 1.0);
+    double damping_const = CLAMP(physicslfo_ramp_at(&x->ramp_damping, sampleframes), 0.0, 1.0);
+    long looping = x->params.looping;
+    double *shared = outs[taps - 1];
+    double *events = (x->events && numouts > x->taps) ? outs[x->taps] : NULL;
+    double sr_inv = x->sr_inv;
+    double phase;
+    long i, k;
+    
+    physics_voice_phase_fixed(v, x->accum_fixed);
+    physicslfo_sync_anchor(x, v, looping, freq_const);
+    
+    // Taps draw their own start energy; damping and physics are shared
+    for (k = 0; k < taps; k++) {
+        physicslfo_jitter_voice(x, v + 1 + k, 1 + k);
+    }
+    
+    if (events) {
+        memset(events, 0, sampleframes * sizeof(double));
+        if (v->event_restart && sampleframes > 0) events[0] = PHYSICSLFO_EVENT_WRAP;
+    }
+    v->event_restart = 0;
+    
+    // Shared phase pass
+    phase = v->phase;
+    for (i = 0; i < sampleframes; i++) {
+        double freq = freq_sig ? CLAMP(freq_in[i], 0.0, PHYSICSLFO_FREQ_MAX) : PHYSICSLFO_FREQ_RAMP(i);
+        double elapsed = trigger_sig ? physicslfo_trigger_edge(v, trigger_in[i]) : 0.0;
+        
+        if (physicslfo_advance_phase(v, looping, &phase, freq * sr_inv, elapsed)) {
+            PHYSICSLFO_EVENT_CYCLE(i);
+        }
+        shared[i] = elapsed > 0.0 ? -phase - 1.0 : phase;
+    }
+    v->phase = phase;
+    v->idle = 0;
+    
+    long type_last = (long)PHYSICSLFO_LOAD_ACQUIRE(&physicslfo_type_count) - 1;
+    long type = PHYSICSLFO_TYPE_OF(type_sig ? type_in[0] : x->params.type, type_last);
+    int type_constant = 1;
+    
+    if (!physics_sig && !damping_sig) {
+        physics_voice_coefs(v, physics_const, damping_const);
+    }
+    if (type_sig) {
+        for (i = 1; i < sampleframes; i++) {
+            if (PHYSICSLFO_TYPE_OF(type_in[i], type_last) != type) {
+                type_constant = 0;
+                break;
+            }
+        }
+    }
+    int morph = type_sig && physicslfo_type_morphing(x, type_in, sampleframes, type_last);
+    
+    if (morph) type_constant = 0;
+    
+    if (type_constant && !physics_sig && !damping_sig) {
+        // Batched pass: each tap turns the shared phase into its own phases,
+        // then the block kernel renders them in place between restarts
+        int single = x->precision_single != 0;
+        
+        for (k = 0; k < taps; k++) {
+            t_physics_voice *tap = v + 1 + k;
+            double offset = x->params.tap_offsets[k];
+            double *out = outs[k];
+            long segment = 0;
+            
+            for (i = 0; i < sampleframes; i++) {
+                double t;
+                
+                if (physicslfo_tap_phase(tap, shared[i], offset, looping, &t)) {
+                    physicslfo_tap_segment(tap, type, out + segment, i - segment, &v->coefs, single);
+                    reset_physics_state(tap);
+                    segment = i;
+                }
+                tap->phase = t;
+                out[i] = t;
+            }
+            physicslfo_tap_segment(tap, type, out + segment, sampleframes - segment, &v->coefs, single);
+        }
+    } else {
+        // Type, physics or damping moving within the block: every tap per sample
+        for (i = 0; i < sampleframes; i++) {
+            double physics_param = physics_sig ? CLAMP(physics_in[i], 0.0, 1.0) : physics_const;
+            double damping = damping_sig ? CLAMP(damping_in[i], 0.0, 1.0) : damping_const;
+            double type_value = type_sig ? type_in[i] : (double)type;
+            double p = shared[i];
+            
+            if (physics_sig || damping_sig)
+                physics_voice_coefs(v, physics_param, damping);
+            
+            for (k = 0; k < taps; k++) {
+                t_physics_voice *tap = v + 1 + k;
+                double t;
+                
+                if (physicslfo_tap_phase(tap, p, x->params.tap_offsets[k], looping, &t))
+                    reset_physics_state(tap);
+                tap->phase = t;
+                outs[k][i] = morph ? physicslfo_morph_sample(tap, type_value, type_last, t, &v->coefs) :
+                             physicslfo_type_sample(tap, PHYSICSLFO_TYPE_OF(type_value, type_last), t, &v->coefs);
+            }
+        }
+    }
+}
+
+PHYSICSLFO_INLINE void physicslfo_perform_block(t_physicslfo *x, double **ins, double **outs, long numouts,
+                                                long sampleframes, const int freq_sig, const int type_sig,
+                                                const int physics_sig, const int damping_sig,
+                                                const int trigger_sig) {
+    long voices = MIN(x->chans, numouts);
+    long i;
+    
+    physicslfo_apply_messages(x);
+    
+    // Float changes ramp over @smooth ms, restarting from wherever the ramp is
+    long smooth_samples = (long)(x->params.smooth * 0.001 * x->sr + 0.5);
+    
+    physicslfo_ramp_retarget(&x->ramp_freq, x->params.freq, smooth_samples);
+    physicslfo_ramp_retarget(&x->ramp_physics, x->params.physics, smooth_samples);
+    physicslfo_ramp_retarget(&x->ramp_damping, x->params.damping, smooth_samples);
+    
+    // @sync: the transport replaces the frequency inlet, so those voices run
+    // the float-frequency variant of the loop
+    long sync = physicslfo_sync_block(x);
+    
+    if (x->taps > 1) {
+        physicslfo_perform_taps(x, ins, outs, numouts, sampleframes, freq_sig && !sync, type_sig, physics_sig,
+                                damping_sig, trigger_sig);
+    } else if (sync) {
+        physicslfo_perform_voices(x, ins, outs, numouts, voices, sampleframes, 0, type_sig, physics_sig, damping_sig,
+                                  trigger_sig);
+    } else {
+        physicslfo_perform_voices(x, ins, outs, numouts, voices, sampleframes, freq_sig, type_sig, physics_sig,
+                                  damping_sig, trigger_sig);
+    }
+    
+    physicslfo_ramp_advance(&x->ramp_freq, sampleframes);
+    physicslfo_ramp_advance(&x->ramp_physics, sampleframes);
+    physicslfo_ramp_advance(&x->ramp_damping, sampleframes);
+    
+    // Report a change of the whole-object idle state from the scheduler
+    long idle = voices > 0;
+    
+    for (i = 0; i < voices && idle; i++) {
+        idle = x->voices[i].idle;
+    }
+    if (idle != x->idle) {
+        x->idle = idle;
+        clock_delay(x->idle_clock, 0);
+    }
+}
+
+// One perform routine per inlet connection pattern (freq, type, physics, damping, trigger)
+#define PHYSICSLFO_DEFINE_PERFORM(f, t, p, d, g) \
+    static void physicslfo_perform64_##f##t##p##d##g(t_physicslfo *x, t_object *dsp64, double **ins, long numins, \
+                                                     double **outs, long numouts, long sampleframes, long flags, \
+                                                     void *userparam) { \
+        physicslfo_perform_block(x, ins, outs, numouts, sampleframes, f, t, p, d, g); \
+    }
+
+// Both trigger variants of one (freq, type, physics, damping) pattern
+#define PHYSICSLFO_DEFINE_PERFORMS(f, t, p, d) \
+    PHYSICSLFO_DEFINE_PERFORM(f, t, p, d, 0) \
+    PHYSICSLFO_DEFINE_PERFORM(f, t, p, d, 1)
+
+#define PHYSICSLFO_PERFORM_PAIR(f, t, p, d) \
+    physicslfo_perform64_##f##t##p##d##0, physicslfo_perform64_##f##t##p##d##1,
+
+PHYSICSLFO_DEFINE_PERFORMS(0, 0, 0, 0)
+PHYSICSLFO_DEFINE_PERFORMS(0, 0, 0, 1)
+PHYSICSLFO_DEFINE_PERFORMS(0, 0, 1, 0)
+PHYSICSLFO_DEFINE_PERFORMS(0, 0, 1, 1)
+PHYSICSLFO_DEFINE_PERFORMS(0, 1, 0, 0)
+PHYSICSLFO_DEFINE_PERFORMS(0, 1, 0, 1)
+PHYSICSLFO_DEFINE_PERFORMS(0, 1, 1, 0)
+PHYSICSLFO_DEFINE_PERFORMS(0, 1, 1, 1)
+PHYSICSLFO_DEFINE_PERFORMS(1, 0, 0, 0)
+PHYSICSLFO_DEFINE_PERFORMS(1, 0, 0, 1)
+PHYSICSLFO_DEFINE_PERFORMS(1, 0, 1, 0)
+PHYSICSLFO_DEFINE_PERFORMS(1, 0, 1, 1)
+PHYSICSLFO_DEFINE_PERFORMS(1, 1, 0, 0)
+PHYSICSLFO_DEFINE_PERFORMS(1, 1, 0, 1)
+PHYSICSLFO_DEFINE_PERFORMS(1, 1, 1, 0)
+PHYSICSLFO_DEFINE_PERFORMS(1, 1, 1, 1)
+
+// Indexed by (freq << 4) | (type << 3) | (physics << 2) | (damping << 1) | trigger
+static const t_physicslfo_perform physicslfo_perform_routines[32] = {
+    PHYSICSLFO_PERFORM_PAIR(0, 0, 0, 0)
+    PHYSICSLFO_PERFORM_PAIR(0, 0, 0, 1)
+    PHYSICSLFO_PERFORM_PAIR(0, 0, 1, 0)
+    PHYSICSLFO_PERFORM_PAIR(0, 0, 1, 1)
+    PHYSICSLFO_PERFORM_PAIR(0, 1, 0, 0)
+    PHYSICSLFO_PERFORM_PAIR(0, 1, 0, 1)
+    PHYSICSLFO_PERFORM_PAIR(0, 1, 1, 0)
+    PHYSICSLFO_PERFORM_PAIR(0, 1, 1, 1)
+    PHYSICSLFO_PERFORM_PAIR(1, 0, 0, 0)
+    PHYSICSLFO_PERFORM_PAIR(1, 0, 0, 1)
+    PHYSICSLFO_PERFORM_PAIR(1, 0, 1, 0)
+    PHYSICSLFO_PERFORM_PAIR(1, 0, 1, 1)
+    PHYSICSLFO_PERFORM_PAIR(1, 1, 0, 0)
+    PHYSICSLFO_PERFORM_PAIR(1, 1, 0, 1)
+    PHYSICSLFO_PERFORM_PAIR(1, 1, 1, 0)
+    PHYSICSLFO_PERFORM_PAIR(1, 1, 1, 1)
+};
+
+//----------------------------------------------------------------------------------------------
+// DSP Profiling (@profile)
+//----------------------------------------------------------------------------------------------
+// dsp64 registers physicslfo_perform64_profile instead of the specialized
+// routine while @profile is on, so instances without it pay nothing. The
+// wrapper reads a monotonic tick counter around the real routine and folds
+// each block into min/max/sum and an eighth-octave histogram (for p99). Stats
+// are guarded by a sequence number like the parameter snapshot, with the audio
+// thread as the writer; getstats copies them on the main thread.
+
+static double physicslfo_tick_ns = 1.0;    // Nanoseconds per timer tick
+
+void physicslfo_timer_init(void) {
+#if defined(__APPLE__)
+    mach_timebase_info_data_t timebase;
+    
+    mach_timebase_info(&timebase);
+    physicslfo_tick_ns = (double)timebase.numer / (double)timebase.denom;
+#elif defined(_WIN32)
+    LARGE_INTEGER frequency;
+    
+    QueryPerformanceFrequency(&frequency);
+    physicslfo_tick_ns = 1e9 / (double)frequency.QuadPart;
+#endif
+}
+
+PHYSICSLFO_INLINE uint64_t physicslfo_timer_ticks(void) {
+#if defined(__APPLE__)
+    return mach_absolute_time();
+#elif defined(_WIN32)
+    LARGE_INTEGER counter;
+    
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)counter.QuadPart;
+#else
+    struct timespec now;
+    
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+#endif
+}
+
+void physicslfo_stats_clear(t_physicslfo_stats *stats) {
+    long i;
+    
+    stats->blocks = 0;
+    stats->total_ns = 0.0;
+    stats->audio_ns = 0.0;
+    stats->min_ns = 0.0;
+    stats->max_ns = 0.0;
+    for (i = 0; i < PHYSICSLFO_PROFILE_BINS; i++) {
+        stats->histogram[i] = 0;
+    }
+}
+
+// Bin k covers [2^(k/8), 2^((k+1)/8)) ns
+PHYSICSLFO_INLINE long physicslfo_stats_bin(double ns) {
+    int exponent;
+    double mantissa = frexp(ns, &exponent);     // ns = mantissa * 2^exponent, mantissa in [0.5, 1)
+    long bin = (exponent - 1) * PHYSICSLFO_PROFILE_OCTAVE +
+               (long)(log2(mantissa * 2.0) * PHYSICSLFO_PROFILE_OCTAVE);
+    
+    return CLAMP(bin, 0, PHYSICSLFO_PROFILE_BINS - 1);
+}
+
+static void physicslfo_perform64_profile(t_physicslfo *x, t_object *dsp64, double **ins, long numins,
+                                         double **outs, long numouts, long sampleframes, long flags,
+                                         void *userparam) {
+    t_physicslfo_perform perform = (t_physicslfo_perform)userparam;
+    t_physicslfo_stats *stats = &x->stats;
+    unsigned long reset = PHYSICSLFO_LOAD_ACQUIRE(&x->stats_reset);
+    uint64_t start = physicslfo_timer_ticks();
+    
+    perform(x, dsp64, ins, numins, outs, numouts, sampleframes, flags, NULL);
+    
+    double ns = (double)(physicslfo_timer_ticks() - start) * physicslfo_tick_ns;
+    unsigned long seq = x->stats_seq;
+    
+    PHYSICSLFO_STORE_RELEASE(&x->stats_seq, seq + 1);
+    PHYSICSLFO_FENCE_RELEASE();
+    if (reset != x->stats_reset_done) {
+        physicslfo_stats_clear(stats);
+        x->stats_reset_done = reset;
+    }
+    if (stats->blocks == 0 || ns < stats->min_ns) stats->min_ns = ns;
+    if (ns > stats->max_ns) stats->max_ns = ns;
+    stats->blocks++;
+    stats->total_ns += ns;
+    stats->audio_ns += sampleframes * x->sr_inv * 1e9;
+    stats->histogram[physicslfo_stats_bin(ns)]++;
+    PHYSICSLFO_STORE_RELEASE(&x->stats_seq, seq + 2);
+}
+
+// Copy of the stats, or 0 if the audio thread kept updating them (main thread)
+int physicslfo_stats_read(t_physicslfo *x, t_physicslfo_stats *out) {
+    long attempt;
+    
+    for (attempt = 0; attempt < 8; attempt++) {
+        unsigned long seq = PHYSICSLFO_LOAD_ACQUIRE(&x->stats_seq);
+        
+        if (!(seq & 1)) {
+            *out = x->stats;
+            PHYSICSLFO_FENCE_ACQUIRE();
+            if (PHYSICSLFO_LOAD_RELAXED(&x->stats_seq) == seq) return 1;
+        }
+    }
+    return 0;
+}
+
+// Smallest bin upper edge below which at least 99% of the blocks fall
+double physicslfo_stats_p99(const t_physicslfo_stats *stats) {
+    unsigned long target = stats->blocks - stats->blocks / 100;
+    unsigned long count = 0;
+    long i;
+    
+    for (i = 0; i < PHYSICSLFO_PROFILE_BINS; i++) {
+        count += stats->histogram[i];
+        if (count >= target) {
+            return MIN(pow(2.0, (i + 1) / (double)PHYSICSLFO_PROFILE_OCTAVE), stats->max_ns);
+        }
+    }
+    return stats->max_ns;
+}
+
+// stats <blocks> <min us> <mean us> <max us> <p99 us> <load %>
+void physicslfo_getstats(t_physicslfo *x) {
+    t_physicslfo_stats stats;
+    t_atom av[6];
+    
+    if (!physicslfo_stats_read(x, &stats)) {
+        post("physicslfo~: stats busy, try getstats again");
+        return;
+    }
+    if (!x->profile && stats.blocks == 0) {
+        post("physicslfo~: no profile data (set @profile 1, then restart audio)");
+    }
+    
+    double mean = stats.blocks ? stats.total_ns / stats.blocks : 0.0;
+    double load = stats.audio_ns > 0.0 ? 100.0 * stats.total_ns / stats.audio_ns : 0.0;
+    
+    atom_setlong(av, (t_atom_long)stats.blocks);
+    atom_setfloat(av + 1, stats.min_ns * 1e-3);
+    atom_setfloat(av + 2, mean * 1e-3);
+    atom_setfloat(av + 3, stats.max_ns * 1e-3);
+    atom_setfloat(av + 4, (stats.blocks ? physicslfo_stats_p99(&stats) : 0.0) * 1e-3);
+    atom_setfloat(av + 5, load);
+    outlet_anything(x->info_outlet, gensym("stats"), 6, av);
+}
+
+//----------------------------------------------------------------------------------------------
+
+// render <buffer~> <seconds>: bake what the object would play after a bang,
+// with the current float controls, into a buffer~. The curve is computed on a
+// worker thread into private memory; only the copy into the buffer~ runs on
+// the main thread, from render_qelem.
+void physicslfo_render(t_physicslfo *x, t_symbol *s, long argc, t_atom *argv) {
+    t_physicslfo_render *r = &x->render;
+    t_buffer_ref *ref;
+    t_symbol *name;
+    double seconds;
+    long frames;
+    
+    if (argc < 2 || atom_gettype(argv) != A_SYM) {
+        object_error((t_object *)x, "render needs a buffer~ name and a length in seconds");
+        return;
+    }
+    if (x->render_thread) {
+        post("physicslfo~: render into %s still running", r->buffer->s_name);
+        return;
+    }
+    name = atom_getsym(argv);
+    seconds = CLAMP(atom_getfloat(argv + 1), 0.0, PHYSICSLFO_RENDER_MAX_SECONDS);
+    frames = (long)(seconds * x->sr + 0.5);
+    if (frames < 1) {
+        object_error((t_object *)x, "render length must be positive");
+        return;
+    }
+    
+    // Fail now rather than after the render when the buffer~ doesn't exist
+    ref = buffer_ref_new((t_object *)x, name);
+    if (!buffer_ref_getobject(ref)) {
+        object_error((t_object *)x, "render: no buffer~ named %s", name->s_name);
+        object_free(ref);
+        return;
+    }
+    object_free(ref);
+    
+    r->data = (float *)sysmem_newptr(frames * sizeof(float));
+    if (!r->data) {
+        object_error((t_object *)x, "out of memory for a %.1f s render", seconds);
+        return;
+    }
+    r->buffer = name;
+    r->seconds = seconds;
+    r->frames = frames;
+    r->type = (long)x->type_float;     // Clamped to the registered types by the inlets
+    r->physics = CLAMP(x->physics_float, 0.0, 1.0);
+    r->damping = CLAMP(x->damping_float, 0.0, 1.0);
+    for (long i = 0; i < PHYSICS_JITTER_AMOUNTS; i++) {
+        r->jitter[i] = x->jitter[i];
+    }
+    r->seed = x->seed;
+    r->inc = CLAMP(x->freq_float, 0.0, PHYSICSLFO_FREQ_MAX) / x->sr;
+    r->looping = x->looping_mode;
+    r->fixed = x->accum_fixed;
+    r->flags = (x->engine_recursive ? PHYSICS_RENDER_RECURSIVE : 0) | (x->precision_single ? PHYSICS_RENDER_SINGLE : 0);
+    r->cancel = 0;
+    
+    if (systhread_create((method)physicslfo_render_thread, x, 0, 0, 0, &x->render_thread) != 0) {
+        object_error((t_object *)x, "render: could not start a worker thread");
+        x->render_thread = NULL;
+        sysmem_freeptr(r->data);
+        r->data = NULL;
+    }
+}
+
+// Append a type to the class-wide registry (main thread). Returns its number,
+// or -1 when the registry is full.
+long physicslfo_type_register(const char *name, const t_physicslfo_plugin *plugin) {
+    unsigned long count = physicslfo_type_count;
+    
+    if (count >= PHYSICSLFO_MAX_TYPES) return -1;
+    physicslfo_types[count].name = name;
+    physicslfo_types[count].plugin = plugin;
+    PHYSICSLFO_STORE_RELEASE(&physicslfo_type_count, count + 1);
+    return (long)count;
+}
+
+// plugin <path>: load a shared library exporting PHYSICSLFO_PLUGIN_SYMBOL and
+// register its type for every instance. Loading the same plugin again reports
+// the type it already has.
+void physicslfo_plugin(t_physicslfo *x, t_symbol *path) {
+    t_physicslfo_plugin_entry entry = NULL;
+    const t_physicslfo_plugin *plugin = NULL;
+    t_atom av[2];
+    long type;
+    
+#if defined(_WIN32)
+    HMODULE library = LoadLibraryA(path->s_name);
+    
+    if (library) entry = (t_physicslfo_plugin_entry)GetProcAddress(library, PHYSICSLFO_PLUGIN_SYMBOL);
+#else
+    void *library = dlopen(path->s_name, RTLD_NOW | RTLD_LOCAL);
+    
+    if (library) entry = (t_physicslfo_plugin_entry)dlsym(library, PHYSICSLFO_PLUGIN_SYMBOL);
+#endif
+    if (!library) {
+        object_error((t_object *)x, "plugin: can't load %s", path->s_name);
+        return;
+    }
+    if (entry) plugin = entry();
+    if (!plugin || plugin->api != PHYSICSLFO_PLUGIN_API || !plugin->name || !plugin->reset || !plugin->render
+        || plugin->state_size < 0 || plugin->state_size > PHYSICSLFO_PLUGIN_STATE) {
+        // The library stays loaded: unloading it is not worth the risk for a bad plugin
+        object_error((t_object *)x, "plugin: %s is not a physicslfo~ plugin (API %d)", path->s_name,
+                     PHYSICSLFO_PLUGIN_API);
+        return;
+    }
+    
+    for (type = PHYSICS_BUILTIN_TYPES; type < (long)physicslfo_type_count; type++) {
+        if (physicslfo_types[type].plugin == plugin) break;
+    }
+    if (type == (long)physicslfo_type_count) {
+        type = physicslfo_type_register(plugin->name, plugin);
+        if (type < 0) {
+            object_error((t_object *)x, "plugin: no room for %s, %d types already", plugin->name,
+                         PHYSICSLFO_MAX_TYPES);
+            return;
+        }
+        post("physicslfo~: Type %ld - %s (plugin %s)", type, plugin->name, path->s_name);
+    }
+    
+    atom_setlong(av, type);
+    atom_setsym(av + 1, gensym(plugin->name));
+    outlet_anything(x->info_outlet, gensym("plugin"), 2, av);
+}
+
+// Steady plugin-type counterpart of physics_voice_render, for the render worker
+static void physicslfo_plugin_voice_render(t_physics_voice *v, long type, double *out, long n, double inc,
+                                           long looping) {
+    double phase = v->phase;
+    long segment = 0;
+    long i;
+    
+    for (i = 0; i < n; i++) {
+        if (physicslfo_advance_phase(v, looping, &phase, inc, 0.0)) {
+            physicslfo_plugin_render(v, type, out + segment, i - segment, &v->coefs);
+            reset_physics_state(v);
+            segment = i;
+        }
+        out[i] = phase;
+    }
+    physicslfo_plugin_render(v, type, out + segment, n - segment, &v->coefs);
+    v->phase = phase;
+}
+
+// Worker thread: a private voice through the core's block render API. Once an
+// envelope has settled the rest of the render is its resting value.
+void *physicslfo_render_thread(t_physicslfo *x) {
+    t_physicslfo_render *r = &x->render;
+    t_physics_voice v = { 0 };
+    double block[PHYSICSLFO_RENDER_BLOCK];
+    long done = 0;
+    long i;
+    
+    physicslfo_jitter_setup(&v, r->jitter);
+    v.jitter_key = physics_random((uint64_t)r->seed, 0);
+    physics_coefs_build(&v.coefs, r->physics, r->damping);
+    physics_voice_coefs(&v, r->physics, r->damping);
+    reset_physics_state(&v);
+    physics_voice_phase_fixed(&v, r->fixed);
+    v.envelope_active = !r->looping;
+    
+    while (done < r->frames && !r->cancel) {
+        long n = MIN(PHYSICSLFO_RENDER_BLOCK, r->frames - done);
+        double rest;
+        
+        if (r->type >= PHYSICS_BUILTIN_TYPES) {
+            physicslfo_plugin_voice_render(&v, r->type, block, n, r->inc, r->looping);
+        } else if (!r->looping && !v.envelope_active && physics_settled(&v, r->type, v.phase, &v.coefs, &rest)) {
+            for (i = done; i < r->frames; i++) {
+                r->data[i] = (float)rest;
+            }
+            break;
+        } else {
+            physics_voice_render(&v, r->type, block, n, r->physics, r->damping, r->inc, r->looping, r->flags);
+        }
+        for (i = 0; i < n; i++) {
+            r->data[done + i] = (float)block[i];
+        }
+        done += n;
+    }
+    
+    qelem_set(x->render_qelem);
+    systhread_exit(0);
+    return NULL;
+}
+
+// Main thread: write a finished render into every channel of its buffer~,
+// resized to the render length, and report it from the info outlet
+void physicslfo_render_finish(t_physicslfo *x) {
+    t_physicslfo_render *r = &x->render;
+    t_buffer_ref *ref;
+    t_buffer_obj *b;
+    unsigned int status;
+    
+    if (!x->render_thread) return;
+    systhread_join(x->render_thread, &status);
+    x->render_thread = NULL;
+    
+    ref = buffer_ref_new((t_object *)x, r->buffer);
+    b = buffer_ref_getobject(ref);
+    if (!b) {
+        object_error((t_object *)x, "render: buffer~ %s went away", r->buffer->s_name);
+    } else {
+        t_atom av[2];
+        float *samples;
+        
+        atom_setlong(av, r->frames);
+        object_method_typed(b, gensym("sizeinsamps"), 1, av, NULL);
+        
+        samples = buffer_locksamples(b);
+        if (samples) {
+            long frames = MIN((long)buffer_getframecount(b), r->frames);
+            long chans = (long)buffer_getchannelcount(b);
+            
+            for (long i = 0; i < frames; i++) {
+                for (long c = 0; c < chans; c++) {
+                    samples[i * chans + c] = r->data[i];
+                }
+            }
+            buffer_unlocksamples(b);
+            buffer_setdirty(b);
+            
+            atom_setsym(av, r->buffer);
+            atom_setfloat(av + 1, r->seconds);
+            outlet_anything(x->info_outlet, gensym("render"), 2, av);
+        } else {
+            object_error((t_object *)x, "render: buffer~ %s has no samples", r->buffer->s_name);
+        }
+    }
+    object_free(ref);
+    
+    sysmem_freeptr(r->data);
+    r->data = NULL;
+}
+
+//----------------------------------------------------------------------------------------------
+
+void physicslfo_float(t_physicslfo *x, double f) {
+    // lores~ pattern: proxy_getinlet works on signal inlets for float routing
+    long inlet = proxy_getinlet((t_object *)x);
+    
+    switch (inlet) {
+        case 0: // Frequency inlet
+            x->freq_float = CLAMP(f, 0.0, PHYSICSLFO_AUDIORATE_FREQ_MAX);  // Capped again where it is used
+            break;
+        case 1: // LFO type inlet
+            {
+                long new_type = (long)CLAMP(f, 0.0, (double)physicslfo_type_count - 1.0);
+                x->type_float = (double)new_type;
+                if (x->verbose) {
+                    physicslfo_log_type(x, new_type);
+                }
+            }
+            break;
+        case 2: // Physics parameter inlet
+            x->physics_float = CLAMP(f, 0.0, 1.0);
+            break;
+        case 3: // Damping inlet
+            x->damping_float = CLAMP(f, 0.0, 1.0);
+            break;
+    }
+    
+    physicslfo_publish_params(x);
+    if (inlet > 0) {
+        physicslfo_table_update(x);
+    }
+}
+
+//----------------------------------------------------------------------------------------------
+
+void physicslfo_int(t_physicslfo *x, long n) {
+    // lores~ pattern: proxy_getinlet works on signal inlets for int routing
+    long inlet = proxy_getinlet((t_object *)x);
+    
+    switch (inlet) {
+        case 0: // Frequency inlet - convert int to float
+            x->freq_float = CLAMP((double)n, 0.0, PHYSICSLFO_AUDIORATE_FREQ_MAX);
+            break;
+        case 1: // LFO type inlet - direct int handling
+            {
+                long new_type = CLAMP(n, 0, (long)physicslfo_type_count - 1);
+                x->type_float = (double)new_type;
+                if (x->verbose) {
+                    physicslfo_log_type(x, new_type);
+                }
+            }
+            break;
+        case 2: // Physics parameter inlet - convert int to float
+            x->physics_float = CLAMP((double)n, 0.0, 1.0);
+            break;
+        case 3: // Damping inlet - convert int to float
+            x->damping_float = CLAMP((double)n, 0.0, 1.0);
+            break;
+    }
+    
+    physicslfo_publish_params(x);
+    if (inlet > 0) {
+        physicslfo_table_update(x);
+    }
+}
+
+//----------------------------------------------------------------------------------------------
+
+void physicslfo_bang(t_physicslfo *x) {
+    // lores~ pattern: proxy_getinlet works on signal inlets for message routing
+    long inlet = proxy_getinlet((t_object *)x);
+    
+    if (inlet == 0) {  // First inlet - mode-specific behavior, applies to every voice
+        physicslfo_push_command(x, PHYSICSLFO_CMD_TRIGGER, -1, !x->looping_mode, 0.0);
+    }
+}
+
+//----------------------------------------------------------------------------------------------
+
+void physicslfo_voicebang(t_physicslfo *x, long n) {
+    // Voices are numbered from 1 like mc channels
+    if (n >= 1 && n <= x->chans) {
+        // With @taps the one voice is the shared phase plus every tap's state
+        physicslfo_push_command(x, PHYSICSLFO_CMD_TRIGGER, x->taps > 1 ? -1 : n - 1, !x->looping_mode, 0.0);
+    } else {
+        post("physicslfo~: voicebang %ld out of range (1-%ld)", n, x->chans);
+    }
+}
+
+//----------------------------------------------------------------------------------------------
+
+// getstate: the next block copies every voice into state_out and state_tick
+// sends it on. With audio off the queue is drained here instead, so the reply
+// still follows everything sent before it.
+void physicslfo_getstate(t_physicslfo *x) {
+    physicslfo_push_command(x, PHYSICSLFO_CMD_GETSTATE, -1, 0, 0.0);
+    if (!sys_getdspobjdspstate((t_object *)x)) {
+        critical_enter(x->message_lock);
+        physicslfo_apply_messages(x);
+        critical_exit(x->message_lock);
+    }
+}
+
+// state <looping> <phase energy bounces velocity spin envelope>... with one
+// record per voice (shared phase first, then each tap, with @taps)
+void physicslfo_state_tick(t_physicslfo *x) {
+    long voices = PHYSICSLFO_VOICE_COUNT(x);
+    long argc = 1 + voices * PHYSICS_VOICE_STATE_FIELDS;
+    t_atom *argv = (t_atom *)sysmem_newptr(argc * sizeof(t_atom));
+    long attempt, i;
+    
+    if (!argv) return;
+    for (attempt = 0; attempt < 8; attempt++) {
+        unsigned long seq = PHYSICSLFO_LOAD_ACQUIRE(&x->state_out_seq);
+        
+        if (seq & 1) continue;
+        atom_setlong(argv, x->state_out_looping);
+        for (i = 0; i < voices; i++) {
+            const t_physics_voice_state *state = x->state_out + i;
+            t_atom *av = argv + 1 + i * PHYSICS_VOICE_STATE_FIELDS;
+            
+            atom_setfloat(av, state->phase);
+            atom_setfloat(av + 1, state->energy);
+            atom_setfloat(av + 2, state->bounce_count);
+            atom_setfloat(av + 3, state->velocity);
+            atom_setfloat(av + 4, state->spin_phase);
+            atom_setlong(av + 5, state->envelope_active);
+        }
+        PHYSICSLFO_FENCE_ACQUIRE();
+        if (PHYSICSLFO_LOAD_RELAXED(&x->state_out_seq) == seq) {
+            outlet_anything(x->info_outlet, gensym("state"), (short)argc, argv);
+            break;
+        }
+    }
+    // Still being rewritten: a newer getstate is on its way and reschedules this clock
+    sysmem_freeptr(argv);
+}
+
+// setstate <looping> <phase energy bounces velocity spin envelope>...: a
+// getstate reply from this or another instance. Voice i takes record i modulo
+// the number of records, so one saved voice seeds them all. The next block
+// loads every voice and the looping mode at once, then carries on from there.
+void physicslfo_setstate(t_physicslfo *x, t_symbol *s, long argc, t_atom *argv) {
+    long voices = PHYSICSLFO_VOICE_COUNT(x);
+    long records = (argc - 1) / PHYSICS_VOICE_STATE_FIELDS;
+    long i;
+    
+    if (records < 1 || (argc - 1) % PHYSICS_VOICE_STATE_FIELDS) {
+        object_error((t_object *)x, "setstate: expected looping mode and %d values per voice",
+                     PHYSICS_VOICE_STATE_FIELDS);
+        return;
+    }
+    
+    // state_in is read by the block that applies it; with audio off nothing reads it
+    if (sys_getdspobjdspstate((t_object *)x) && PHYSICSLFO_LOAD_ACQUIRE(&x->state_in_pending)) {
+        object_error((t_object *)x, "setstate: previous state not applied yet");
+        return;
+    }
+    
+    for (i = 0; i < voices; i++) {
+        const t_atom *av = argv + 1 + (i % records) * PHYSICS_VOICE_STATE_FIELDS;
+        t_physics_voice_state *state = x->state_in + i;
+        
+        state->phase = MAX(atom_getfloat(av), 0.0);
+        state->energy = CLAMP(atom_getfloat(av + 1), 0.0, 1.0);
+        state->bounce_count = MAX(atom_getfloat(av + 2), 0.0);
+        state->velocity = atom_getfloat(av + 3);
+        state->spin_phase = atom_getfloat(av + 4);
+        state->envelope_active = atom_getlong(av + 5) ? 1 : 0;
+    }
+    PHYSICSLFO_STORE_RELEASE(&x->state_in_pending, 1);
+    
+    // Published before the event, so the block that loads the state sees the mode
+    x->looping_mode = atom_getlong(argv) ? 1 : 0;
+    physicslfo_publish_params(x);
+    if (!physicslfo_push_command(x, PHYSICSLFO_CMD_SETSTATE, -1, 0, 0.0)) {
+        PHYSICSLFO_STORE_RELEASE(&x->state_in_pending, 0);
+    }
+}
+
+//----------------------------------------------------------------------------------------------
+
+void physicslfo_looping(t_physicslfo *x, long n) {
+    x->looping_mode = n ? 1 : 0;  // Convert to boolean
+    physicslfo_publish_params(x);
+    
+    if (!x->looping_mode) {
+        // Switched to envelope mode - stop any current envelope
+        physicslfo_push_command(x, PHYSICSLFO_CMD_STOP_ENVELOPE, -1, 0, 0.0);
+    }
+}
+
+//----------------------------------------------------------------------------------------------
+
+void physicslfo_phase(t_physicslfo *x, double f) {
+    if (x->looping_mode) {
+        // Only works in looping mode
+        physicslfo_push_command(x, PHYSICSLFO_CMD_PHASE, -1, 0, CLAMP(f, 0.0, 1.0));
+    } else {
+        post("physicslfo~: phase message only works in looping mode (send 'looping 1' first)");
+    }
+}
+
+//----------------------------------------------------------------------------------------------
+
+t_max_err physicslfo_engine_set(t_physicslfo *x, void *attr, long argc, t_atom *argv) {
+    if (argc && argv) {
+        t_symbol *engine = atom_getsym(argv);
+        
+        if (engine == gensym("closed") || engine == gensym("recursive")) {
+            x->engine = engine;
+            x->engine_recursive = (engine == gensym("recursive"));
+        } else {
+            post("physicslfo~: unknown engine %s (expected closed or recursive)", engine->s_name);
+        }
+    }
+    return MAX_ERR_NONE;
+}
+
+t_max_err physicslfo_precision_set(t_physicslfo *x, void *attr, long argc, t_atom *argv) {
+    if (argc && argv) {
+        t_symbol *precision = atom_getsym(argv);
+        
+        if (precision == gensym("double") || precision == gensym("single")) {
+            x->precision = precision;
+            x->precision_single = (precision == gensym("single"));
+        } else {
+            post("physicslfo~: unknown precision %s (expected double or single)", precision->s_name);
+        }
+    }
+    return MAX_ERR_NONE;
+}
+
+t_max_err physicslfo_decimate_set(t_physicslfo *x, void *attr, long argc, t_atom *argv) {
+    if (argc && argv) {
+        x->decimate = CLAMP(atom_getlong(argv), 1, PHYSICSLFO_DECIMATE_MAX);
+    }
+    return MAX_ERR_NONE;
+}
+
+t_max_err physicslfo_interp_set(t_physicslfo *x, void *attr, long argc, t_atom *argv) {
+    if (argc && argv) {
+        t_symbol *interp = atom_getsym(argv);
+        
+        if (interp == gensym("linear") || interp == gensym("cubic")) {
+            x->interp = interp;
+            x->interp_cubic = (interp == gensym("cubic"));
+        } else {
+            post("physicslfo~: unknown interp %s (expected linear or cubic)", interp->s_name);
+        }
+    }
+    return MAX_ERR_NONE;
+}
+
+t_max_err physicslfo_accum_set(t_physicslfo *x, void *attr, long argc, t_atom *argv) {
+    if (argc && argv) {
+        t_symbol *accum = atom_getsym(argv);
+        
+        if (accum == gensym("double") || accum == gensym("fixed")) {
+            x->accum = accum;
+            x->accum_fixed = (accum == gensym("fixed"));
+        } else {
+            post("physicslfo~: unknown accum %s (expected double or fixed)", accum->s_name);
+        }
+    }
+    return MAX_ERR_NONE;
+}
+
+t_max_err physicslfo_quality_set(t_physicslfo *x, void *attr, long argc, t_atom *argv) {
+    if (argc && argv) {
+        t_symbol *quality = atom_getsym(argv);
+        
+        if (quality == gensym("exact") || quality == gensym("table")) {
+            x->quality = quality;
+            x->quality_table = (quality == gensym("table"));
+            physicslfo_table_update(x);
+        } else {
+            post("physicslfo~: unknown quality %s (expected exact or table)", quality->s_name);
+        }
+    }
+    return MAX_ERR_NONE;
+}
+
+t_max_err physicslfo_tablesize_set(t_physicslfo *x, void *attr, long argc, t_atom *argv) {
+    if (argc && argv) {
+        x->table_size = CLAMP(atom_getlong(argv), PHYSICSLFO_TABLE_MIN_SIZE, PHYSICSLFO_TABLE_MAX_SIZE);
+        physicslfo_table_update(x);
+    }
+    return MAX_ERR_NONE;
+}
+
+t_max_err physicslfo_chans_set(t_physicslfo *x, void *attr, long argc, t_atom *argv) {
+    if (argc && argv) {
+        if (x->voices) {
+            // The outlet and voice storage are fixed once the object exists
+            post("physicslfo~: @chans can only be set when the object is created");
+        } else {
+            x->chans = CLAMP(atom_getlong(argv), 1, PHYSICSLFO_MAX_VOICES);
+        }
+    }
+    return MAX_ERR_NONE;
+}
+
+t_max_err physicslfo_taps_set(t_physicslfo *x, void *attr, long argc, t_atom *argv) {
+    if (argc && argv) {
+        if (x->voices) {
+            // One outlet per tap, fixed once the object exists
+            post("physicslfo~: @taps can only be set when the object is created");
+        } else {
+            x->taps = CLAMP(atom_getlong(argv), 1, PHYSICSLFO_MAX_TAPS);
+        }
+    }
+    return MAX_ERR_NONE;
+}
+
+t_max_err physicslfo_events_set(t_physicslfo *x, void *attr, long argc, t_atom *argv) {
+    if (argc && argv) {
+        if (x->voices) {
+            post("physicslfo~: @events can only be set when the object is created");
+        } else {
+            x->events = atom_getlong(argv) ? 1 : 0;
+        }
+    }
+    return MAX_ERR_NONE;
+}
+
+t_max_err physicslfo_offsets_set(t_physicslfo *x, void *attr, long argc, t_atom *argv) {
+    if (argc && argv) {
+        long count = MIN(argc, PHYSICSLFO_MAX_TAPS);
+        
+        for (long i = 0; i < count; i++) {
+            double offset = atom_getfloat(argv + i);
+            
+            x->tap_offsets[i] = offset - floor(offset);     // Lag in cycles, wrapped to 0-1
+        }
+        for (long i = count; i < x->taps; i++) {
+            x->tap_offsets[i] = (double)i / (double)x->taps;      // The rest stay evenly spread
+        }
+        x->tap_offsets_count = count;
+        physicslfo_publish_params(x);
+    }
+    return MAX_ERR_NONE;
+}
+
+t_max_err physicslfo_smooth_set(t_physicslfo *x, void *attr, long argc, t_atom *argv) {
+    if (argc && argv) {
+        x->smooth_ms = CLAMP(atom_getfloat(argv), 0.0, 10000.0);
+        physicslfo_publish_params(x);
+    }
+    return MAX_ERR_NONE;
+}
+
+t_max_err physicslfo_jitter_set(t_physicslfo *x, void *attr, long argc, t_atom *argv) {
+    if (argc && argv) {
+        long count = MIN(argc, PHYSICS_JITTER_AMOUNTS);
+        
+        for (long i = 0; i < PHYSICS_JITTER_AMOUNTS; i++) {
+            // A single amount applies to energy, damping and physics alike
+            x->jitter[i] = CLAMP(atom_getfloat(argv + (i < count ? i : 0)), 0.0, 1.0);
+        }
+        x->jitter_count = count;
+        physicslfo_table_update(x);     // Jittered cycles can't come from a table
+        physicslfo_publish_params(x);
+    }
+    return MAX_ERR_NONE;
+}
+
+t_max_err physicslfo_seed_set(t_physicslfo *x, void *attr, long argc, t_atom *argv) {
+    if (argc && argv) {
+        x->seed = atom_getlong(argv);
+        x->jitter_epoch++;
+        physicslfo_publish_params(x);
+    }
+    return MAX_ERR_NONE;
+}
+
+// Period of a note value in ticks (4n, 8nd = dotted, 16nt = triplet) or in
+// bars (1m, 2m, ...); "off" and anything unparsable return 0
+int physicslfo_sync_parse(t_symbol *s, double *notes, double *bars) {
+    const char *text = s->s_name;
+    char *end;
+    long count = strtol(text, &end, 10);
+    
+    *notes = 0.0;
+    *bars = 0.0;
+    if (count <= 0 || end == text) return 0;
+    
+    if (end[0] == 'm' && end[1] == 0) {
+        *bars = (double)count;
+        return 1;
+    }
+    if (end[0] != 'n') return 0;
+    
+    double ticks = PHYSICSLFO_SYNC_TICKS_PER_WHOLE / count;
+    
+    if (end[1] == 'd' && end[2] == 0) {
+        ticks *= 1.5;
+    } else if (end[1] == 't' && end[2] == 0) {
+        ticks *= 2.0 / 3.0;
+    } else if (end[1] != 0) {
+        return 0;
+    }
+    *notes = ticks;
+    return 1;
+}
+
+// Dereference replaced transports that perform can no longer be reading: two
+// completed reads since the swap, or the object is not in a running DSP chain
+// (main thread). Reschedules itself while any are left.
+void physicslfo_sync_retire_tick(t_physicslfo *x) {
+    unsigned long reads = PHYSICSLFO_LOAD_ACQUIRE(&x->sync_reads);
+    long running = sys_getdspobjdspstate((t_object *)x);
+    long pending = 0;
+    long i;
+    
+    for (i = 0; i < PHYSICSLFO_SYNC_RETIRED; i++) {
+        if (!x->sync_retired[i]) continue;
+        if (!running || reads - x->sync_retired_at[i] >= 2) {
+            itm_dereference(x->sync_retired[i]);
+            x->sync_retired[i] = NULL;
+        } else {
+            pending = 1;
+        }
+    }
+    if (pending) {
+        clock_delay(x->sync_clock, PHYSICSLFO_SYNC_RETIRE_POLL);
+    }
+}
+
+// Point perform at the transport @sync and @transport call for (main thread)
+void physicslfo_sync_update(t_physicslfo *x) {
+    t_itm *old = x->sync_itm;
+    t_itm *itm = NULL;
+    long slot;
+    
+    if (x->sync_notes > 0.0 || x->sync_bars > 0.0) {
+        if (x->transport && x->transport->s_name[0]) {
+            itm = (t_itm *)itm_getnamed(x->transport, NULL, NULL, 1);
+        } else {
+            itm = (t_itm *)itm_getglobal();
+        }
+    }
+    if (itm == old) return;
+    
+    // A free slot for the reference perform may still be using
+    physicslfo_sync_retire_tick(x);
+    slot = 0;
+    while (slot < PHYSICSLFO_SYNC_RETIRED && x->sync_retired[slot]) slot++;
+    if (old && slot == PHYSICSLFO_SYNC_RETIRED) {
+        object_error((t_object *)x, "transport changes too fast, keeping the previous one");
+        return;
+    }
+    
+    if (itm) itm_reference(itm);
+    PHYSICSLFO_STORE_RELEASE_PTR(&x->sync_itm, itm);
+    if (old) {
+        x->sync_retired[slot] = old;
+        x->sync_retired_at[slot] = PHYSICSLFO_LOAD_ACQUIRE(&x->sync_reads);
+        physicslfo_sync_retire_tick(x);
+    }
+}
+
+t_max_err physicslfo_sync_set(t_physicslfo *x, void *attr, long argc, t_atom *argv) {
+    if (argc && argv) {
+        t_symbol *sync = atom_getsym(argv);
+        double notes, bars;
+        
+        if (sync == gensym("off") || physicslfo_sync_parse(sync, &notes, &bars)) {
+            if (sync == gensym("off")) notes = bars = 0.0;
+            x->sync = sync;
+            x->sync_notes = notes;
+            x->sync_bars = bars;
+            physicslfo_publish_params(x);
+            physicslfo_sync_update(x);
+        } else {
+            post("physicslfo~: unknown sync %s (expected off or a note value like 4n, 8nd, 16nt, 1m)",
+                 sync->s_name);
+        }
+    }
+    return MAX_ERR_NONE;
+}
+
+t_max_err physicslfo_transport_set(t_physicslfo *x, void *attr, long argc, t_atom *argv) {
+    x->transport = (argc && argv) ? atom_getsym(argv) : gensym("");
+    physicslfo_sync_update(x);
+    return MAX_ERR_NONE;
+}
+
+t_max_err physicslfo_profile_set(t_physicslfo *x, void *attr, long argc, t_atom *argv) {
+    if (argc && argv) {
+        long profile = atom_getlong(argv) != 0;
+        
+        // Switching profiling on starts a fresh measurement; the audio thread
+        // clears the stats before the next timed block
+        if (profile && !x->profile) {
+            PHYSICSLFO_STORE_RELEASE(&x->stats_reset, x->stats_reset + 1);
+        }
+        x->profile = profile;
+    }
+    return MAX_ERR_NONE;
+}
+
+t_max_err physicslfo_oversample_set(t_physicslfo *x, void *attr, long argc, t_atom *argv) {
+    if (argc && argv) {
+        long factor = CLAMP(atom_getlong(argv), 1, PHYSICSLFO_OVERSAMPLE_MAX);
+        
+        // Each stage halves the rate, so round down to a power of two
+        while (factor & (factor - 1)) {
+            factor &= factor - 1;
+        }
+        x->oversample = factor;
+    }
+    return MAX_ERR_NONE;
+}
+
+long physicslfo_multichanneloutputs(t_physicslfo *x, long index) {
+    return x->chans;
+}
+
+//----------------------------------------------------------------------------------------------
+
+void physicslfo_assist(t_physicslfo *x, void *b, long m, long a, char *s) {
+    if (m == ASSIST_INLET) {
+        switch (a) {
             case 0:
                 sprintf(s, "(signal/float/bang) Frequency in Hz, bang to reset/trigger");
                 break;
             case 1:
-                sprintf(s, "(signal/float/int) Physics type (0-5)");
+                sprintf(s, "(signal/float/int) Physics type (0-5, loaded plugins from 6)");
                 break;
             case 2:
                 sprintf(s, "(signal/float) Physics parameter (0-1)");
@@ -404,9 +3326,24 @@ void physicslfo_assist(t_physicslfo *x, void *b, long m, long a, char *s) {
             case 3:
                 sprintf(s, "(signal/float) Damping (0-1)");
                 break;
+            case 4:
+                sprintf(s, "(signal) Trigger: rising edge restarts the cycle at that exact sample");
+                break;
+        }
+    } else if (a == PHYSICSLFO_SIGNAL_OUTLETS(x) + 1) {  // ASSIST_OUTLET
+        sprintf(s, "(list) stats (getstats), state (getstate), render, plugin");
+    } else if (a == PHYSICSLFO_SIGNAL_OUTLETS(x)) {
+        sprintf(s, "(int) 1 when every envelope has settled, 0 when one is active again");
+    } else if (x->events && a == PHYSICSLFO_SIGNAL_OUTLETS(x) - 1) {
+        sprintf(s, "(signal) Events: 1 at each new cycle, 0.5 at each ground contact");
+    } else if (x->taps > 1 && a < x->taps) {
+        sprintf(s, "(signal) Tap %ld, %.3f cycles behind the shared phase (0 to 1)", a + 1, x->tap_offsets[a]);
+    } else {
+        if (x->chans > 1) {
+            sprintf(s, "(multichannel signal) %ld physics LFO voices (0 to 1)", x->chans);
+        } else {
+            sprintf(s, "(signal) Physics LFO output (0 to 1) - natural physics range");
         }
-    } else {  // ASSIST_OUTLET
-        sprintf(s, "(signal) Physics LFO output (0 to 1) - natural physics range");
     }
 }
 
@@ -414,14 +3351,6 @@ void physicslfo_assist(t_physicslfo *x, void *b, long m, long a, char *s) {
 // Helper Functions
 //----------------------------------------------------------------------------------------------
 
-void reset_physics_state(t_physicslfo *x) {
-    x->velocity = 0.0;
-    x->acceleration = 0.0;
-    x->energy = 1.0;           // Full energy at start
-    x->bounce_count = 0.0;
-    x->spin_phase = 0.0;
-}
-
 void print_physics_info(t_physicslfo *x, long type) {
     switch (type) {
         case 0:
@@ -443,190 +3372,292 @@ void print_physics_info(t_physicslfo *x, long type) {
             post("physicslfo~: Type 5 - WOBBLE (settles) | Param: frequency spread (0=simple, 1=complex) | Damping: settling speed");
             break;
         default:
-            post("physicslfo~: Unknown physics type %ld", type);
+            if (type >= 0 && type < (long)physicslfo_type_count) {
+                post("physicslfo~: Type %ld - %s (plugin)", type, physicslfo_types[type].name);
+            } else {
+                post("physicslfo~: Unknown physics type %ld", type);
+            }
             break;
     }
 }
 
+// Queue a type report. Posts happen on the low-priority queue at most once per
+// PHYSICSLFO_LOG_INTERVAL; changes in between collapse into the latest type.
+void physicslfo_log_type(t_physicslfo *x, long type) {
+    x->log_type = type;
+    if (!x->log_pending) {
+        unsigned long elapsed = systime_ms() - x->log_last;
+        
+        x->log_pending = 1;
+        if (!x->log_last || elapsed >= PHYSICSLFO_LOG_INTERVAL) {
+            defer_low(x, (method)physicslfo_log_flush, NULL, 0, NULL);
+        } else {
+            clock_delay(x->log_clock, (long)(PHYSICSLFO_LOG_INTERVAL - elapsed));
+        }
+    }
+}
+
+void physicslfo_idle_tick(t_physicslfo *x) {
+    outlet_int(x->idle_outlet, x->idle);
+}
+
+void physicslfo_log_tick(t_physicslfo *x) {
+    defer_low(x, (method)physicslfo_log_flush, NULL, 0, NULL);
+}
+
+void physicslfo_log_flush(t_physicslfo *x, t_symbol *s, short argc, t_atom *argv) {
+    x->log_pending = 0;
+    x->log_last = systime_ms();
+    print_physics_info(x, x->log_type);
+}
+
 //----------------------------------------------------------------------------------------------
-// Physics Simulation Functions
+// Wavetable Cache (@quality table)
 //----------------------------------------------------------------------------------------------
+// One looping cycle of a shape depends only on the type, physics parameter,
+// damping and table size, so identical LFOs can share a single rendered table.
+// Tables live in a class-wide list keyed by (type, quantized param, quantized
+// damping, size) and are reference counted. Released tables are kept around as
+// spares, so sweeping a parameter back and forth reuses them; the oldest spare
+// is freed once there are more than PHYSICSLFO_TABLE_SPARES of them.
 
-double simulate_bounce(t_physicslfo *x, double t, double param, double damping) {
-    // Simple bounce: param controls how "bouncy" vs "droopy" the curve is
-    // param = 0.0: very droopy (slow fall, sharp bounce)
-    // param = 1.0: very bouncy (fast fall, high bounce)
-    
-    double curve_power = 0.5 + param * 3.0;  // 0.5 to 3.5 power curve
-    
-    // Apply continuous damping throughout the bounce cycle
-    // Higher damping = lower overall energy and faster decay
-    double decay_factor = 1.0 - (damping * t * 1.5);  // More dramatic continuous energy loss
-    double bounce_height = x->energy * fmax(0.1, decay_factor);  // Don't go below 10%
-    
-    // Simple parabolic trajectory with variable curve sharpness
-    // Higher param = sharper, more "bouncy" curve
-    double height = bounce_height * (1.0 - pow(t, curve_power));
+static t_physics_table *physicslfo_table_cache = NULL;
+static unsigned long physicslfo_table_clock = 0;    // Release stamp source for spare eviction
+
+// Render the cycle band-limited (see physics_cycle_render) from the quantized key
+void physics_table_render(t_physics_table *table) {
+    physics_cycle_render(table->type, (double)table->param_step / PHYSICSLFO_TABLE_QUANT,
+                         (double)table->damping_step / PHYSICSLFO_TABLE_QUANT,
+                         table->data, table->size, PHYSICSLFO_TABLE_OVERSAMPLE);
+}
+
+// Drop requests nobody waits for any more, unless the worker is on them, then
+// free the oldest spares beyond the limit. Called with the cache lock held.
+static void physics_table_trim(void) {
+    t_physics_table **link = &physicslfo_table_cache;
     
-    // Ground collision and additional energy loss
-    if (height <= 0.0) {
-        height = 0.0;
-        x->energy *= (1.0 - damping * 0.8);  // Even more dramatic energy loss on bounce
-        x->bounce_count += 1.0;
+    while (*link) {
+        t_physics_table *table = *link;
+        
+        if (table->refcount == 0 && !table->ready && !table->rendering) {
+            *link = table->next;
+            sysmem_freeptr(table->data);
+            sysmem_freeptr(table);
+        } else {
+            link = &table->next;
+        }
     }
     
-    return CLAMP(height, 0.0, 1.0);
+    for (;;) {
+        t_physics_table **link, **oldest = NULL;
+        long spares = 0;
+        
+        for (link = &physicslfo_table_cache; *link; link = &(*link)->next) {
+            if ((*link)->refcount == 0 && (*link)->ready) {
+                spares++;
+                if (!oldest || (*link)->released < (*oldest)->released) {
+                    oldest = link;
+                }
+            }
+        }
+        if (spares <= PHYSICSLFO_TABLE_SPARES) break;
+        
+        t_physics_table *victim = *oldest;
+        *oldest = victim->next;
+        sysmem_freeptr(victim->data);
+        sysmem_freeptr(victim);
+    }
 }
 
-double simulate_elastic(t_physicslfo *x, double t, double tension, double damping) {
-    // Damped oscillation - decay envelope with vibrations inside (like struck bell or plucked string)
-    
-    // Oscillation frequency controlled by tension parameter
-    double osc_frequency = 3.0 + tension * 12.0;  // 3-15 Hz vibration frequency
-    
-    // Exponential decay envelope - starts at 1.0 and decays toward 0
-    double decay_rate = 1.0 + damping * 4.0;  // 1-5 decay rate (damping controls how fast it dies out)
-    double decay_envelope = exp(-decay_rate * t);
-    
-    // Oscillation inside the decay envelope
-    double oscillation = sin(2.0 * PI * osc_frequency * t);
-    
-    // Optional: Add slight frequency drift as energy dissipates (like real physical systems)
-    double freq_drift = 1.0 - (t * 0.1 * tension);  // Slight frequency drop over time
-    freq_drift = fmax(0.8, freq_drift);  // Don't let it drift too much
-    oscillation = sin(2.0 * PI * osc_frequency * freq_drift * t);
-    
-    // Combine: oscillation amplitude modulated by decay envelope
-    double result = decay_envelope * oscillation;
-    
-    // Scale and offset to 0-1 range (decay starts high, oscillates toward zero)
-    result = (result + 1.0) * 0.5;  // Convert from ±1 to 0-1
-    result *= decay_envelope;       // Apply envelope again for proper decay to zero
-    
-    return result;
+static int physics_table_matches(const t_physics_table *table, long type, long param_step, long damping_step,
+                                 long size) {
+    return table && table->type == type && table->param_step == param_step
+           && table->damping_step == damping_step && table->size == size;
 }
 
-double simulate_bounce_spin(t_physicslfo *x, double t, double param, double damping) {
-    // Enhanced bounce with dynamic spin - more movement and character
-    double curve_power = 0.3 + param * 2.5;  // More responsive curve variation
-    
-    // Apply continuous damping with spin-dependent energy retention
-    double decay_factor = 1.0 - (damping * t * 1.0);  // Slower decay for more movement
-    double bounce_height = x->energy * fmax(0.15, decay_factor);
-    
-    // Basic bounce trajectory  
-    double base_bounce = bounce_height * (1.0 - pow(t, curve_power));
-    
-    // Enhanced multi-frequency spin system
-    double primary_spin_freq = 3.0 + param * 12.0;   // Higher frequency range (3-15 Hz)
-    double secondary_spin_freq = 1.5 + param * 6.0;   // Secondary harmonic (1.5-7.5 Hz)
-    
-    // Create complex spin pattern with multiple frequencies
-    double primary_spin = sin(2.0 * PI * primary_spin_freq * t);
-    double secondary_spin = sin(2.0 * PI * secondary_spin_freq * t + PI/3);  // Phase offset
-    double complex_spin = (primary_spin * 0.7) + (secondary_spin * 0.3);     // Mix harmonics
-    
-    // Dynamic spin influence that increases with parameter and bounce energy
-    double spin_base_influence = 0.3 + param * 0.4;  // 0.3 to 0.7 influence range
-    double energy_boost = 1.0 + (x->energy * 0.5);   // More spin when more energy
-    double spin_influence = spin_base_influence * base_bounce * energy_boost;
-    
-    // Add wobble effect - slower frequency modulation
-    double wobble_freq = 0.5 + param * 1.5;  // 0.5-2 Hz wobble
-    double wobble = sin(2.0 * PI * wobble_freq * t) * 0.15 * param;  // Subtle wobble
-    
-    // Combine all effects
-    double final_height = base_bounce + (complex_spin * spin_influence) + (wobble * base_bounce);
+static t_physics_table *physics_table_find(long type, long param_step, long damping_step, long size) {
+    t_physics_table *table;
     
-    // Ground collision and energy loss (less aggressive to maintain movement)
-    if (final_height <= 0.0) {
-        final_height = 0.0;
-        x->energy *= (1.0 - damping * 0.5);  // Reduced energy loss for more bounces
-        x->bounce_count += 1.0;
+    for (table = physicslfo_table_cache; table; table = table->next) {
+        if (physics_table_matches(table, type, param_step, damping_step, size)) {
+            return table;
+        }
     }
-    
-    return fmax(0.0, final_height);
+    return NULL;
 }
 
-double simulate_elastic_overshoot(t_physicslfo *x, double t, double tension, double damping) {
-    // Step response with overshoot that settles to equilibrium
-    double freq = 1.0 + tension * 4.0;    // Oscillation frequency
-    double overshoot_amount = 0.3 + tension * 0.4; // How much overshoot (0.3-0.7)
-    
-    // Target equilibrium (where it eventually settles)
-    double equilibrium = 0.6;
-    
-    // Exponential approach to equilibrium with proper settling
-    double approach_rate = 2.0 + damping * 3.0;  // How fast it approaches equilibrium
-    double base_approach = equilibrium * (1.0 - exp(-approach_rate * t));
-    
-    // Overshoot oscillation that properly decays to zero
-    double overshoot_decay = exp(-damping * t * 2.5);  // Stronger decay
-    double overshoot_osc = sin(2.0 * PI * freq * t) * overshoot_amount * overshoot_decay;
-    
-    // Cut off oscillations when they become negligible
-    if (overshoot_decay < 0.01) {
-        overshoot_osc = 0.0;
+// Worker thread: render every table still waiting, one at a time with the
+// cache unlocked, then sleep until the next request
+static void *physics_table_worker(void *arg) {
+    for (;;) {
+        systhread_mutex_lock(physicslfo_table_worker_mutex);
+        while (!physicslfo_table_jobs) {
+            systhread_cond_wait(physicslfo_table_worker_cond, physicslfo_table_worker_mutex);
+        }
+        physicslfo_table_jobs = 0;
+        systhread_mutex_unlock(physicslfo_table_worker_mutex);
+        
+        for (;;) {
+            t_physics_table *table;
+            
+            critical_enter(physicslfo_table_lock);
+            for (table = physicslfo_table_cache; table; table = table->next) {
+                if (!table->ready && !table->rendering) break;
+            }
+            if (table) table->rendering = 1;
+            critical_exit(physicslfo_table_lock);
+            if (!table) break;
+            
+            physics_table_render(table);
+            
+            critical_enter(physicslfo_table_lock);
+            table->rendering = 0;
+            PHYSICSLFO_STORE_RELEASE(&table->ready, 1);
+            physics_table_trim();
+            critical_exit(physicslfo_table_lock);
+        }
     }
-    
-    return base_approach + overshoot_osc;
+    return NULL;
 }
 
-double simulate_multibounce(t_physicslfo *x, double t, double param, double damping) {
-    // Multiple bounces that eventually come to complete rest
-    double bounces_per_cycle = 2.0 + param * 6.0;  // 2-8 bounces per cycle
+// Returns a referenced table for the key. A key no instance has asked for yet
+// gets an entry the worker renders; its ready flag says when it can be played.
+t_physics_table *physics_table_acquire(long type, long param_step, long damping_step, long size) {
+    t_physics_table *table, *fresh;
     
-    // Which bounce segment are we in?
-    double segment_phase = fmod(t * bounces_per_cycle, 1.0);
-    long current_bounce = (long)(t * bounces_per_cycle);
+    critical_enter(physicslfo_table_lock);
+    table = physics_table_find(type, param_step, damping_step, size);
+    if (table) table->refcount++;
+    critical_exit(physicslfo_table_lock);
+    if (table) return table;
     
-    // Parabolic trajectory for each bounce
-    double height = 4.0 * segment_phase * (1.0 - segment_phase);
+    fresh = (t_physics_table *)sysmem_newptrclear(sizeof(t_physics_table));
+    if (!fresh) return NULL;
+    fresh->data = (double *)sysmem_newptr((size + 1) * sizeof(double));
+    if (!fresh->data) {
+        sysmem_freeptr(fresh);
+        return NULL;
+    }
+    fresh->type = type;
+    fresh->param_step = param_step;
+    fresh->damping_step = damping_step;
+    fresh->size = size;
+    fresh->refcount = 1;
     
-    // More aggressive exponential decay per bounce
-    double energy_loss_per_bounce = 0.5 + damping * 0.4;  // 50-90% energy retained per bounce
-    double bounce_amplitude = pow(energy_loss_per_bounce, current_bounce);
+    // Another instance may have added the key while we allocated
+    critical_enter(physicslfo_table_lock);
+    table = physics_table_find(type, param_step, damping_step, size);
+    if (table) {
+        table->refcount++;
+    } else {
+        fresh->next = physicslfo_table_cache;
+        physicslfo_table_cache = fresh;
+    }
+    critical_exit(physicslfo_table_lock);
     
-    // Complete stop when amplitude becomes negligible
-    double stop_threshold = 0.02;  // Stop when below 2%
-    if (bounce_amplitude < stop_threshold) {
-        return 0.0;  // Complete rest
+    if (table) {
+        sysmem_freeptr(fresh->data);
+        sysmem_freeptr(fresh);
+        return table;
     }
     
-    return height * bounce_amplitude;
+    systhread_mutex_lock(physicslfo_table_worker_mutex);
+    if (!physicslfo_table_worker) {
+        systhread_create((method)physics_table_worker, NULL, 0, SYSTHREAD_PRIORITY_MIN, 0,
+                         &physicslfo_table_worker);
+    }
+    physicslfo_table_jobs++;
+    systhread_cond_signal(physicslfo_table_worker_cond);
+    systhread_mutex_unlock(physicslfo_table_worker_mutex);
+    return fresh;
 }
 
-double simulate_wobble(t_physicslfo *x, double t, double tension, double damping) {
-    // Wobble that eventually settles to equilibrium position
-    double base_freq = 1.5 + tension * 2.5;          // Base frequency
-    double freq_spread = tension * 0.8;              // Frequency spread for beating
-    
-    double freq1 = base_freq;
-    double freq2 = base_freq + freq_spread;
-    
-    // Equilibrium position where wobble settles
-    double equilibrium = 0.5;
+void physics_table_release(t_physics_table *table) {
+    if (!table) return;
     
-    // Approach equilibrium over time
-    double approach_rate = 1.5 + damping * 2.0;
-    double base_level = equilibrium * (1.0 - exp(-approach_rate * t));
-    
-    // Wobble oscillations that properly decay to zero
-    double wobble_decay = exp(-damping * t * 1.2);  // Stronger decay than before
-    
-    // Create smooth beating pattern
-    double osc1 = sin(2.0 * PI * freq1 * t);
-    double osc2 = sin(2.0 * PI * freq2 * t);
-    double beating = (osc1 + osc2 * 0.8) / 1.8;     // Weighted average
+    critical_enter(physicslfo_table_lock);
+    if (--table->refcount == 0) {
+        table->released = ++physicslfo_table_clock;
+        physics_table_trim();
+    }
+    critical_exit(physicslfo_table_lock);
+}
+
+// Swap the wanted table (NULL for none) in once it is rendered, and release
+// replaced tables once perform has moved past them. Called with message_lock
+// held; returns 1 while there is still something to wait for.
+static long physicslfo_table_service(t_physicslfo *x) {
+    unsigned long reads = PHYSICSLFO_LOAD_ACQUIRE(&x->sync_reads);
+    long running = sys_getdspobjdspstate((t_object *)x);
+    long retiring = 0;
+    long i;
     
-    // Cut off wobble when it becomes negligible
-    double wobble_amplitude = 0.3 * wobble_decay;
-    if (wobble_decay < 0.01) {
-        wobble_amplitude = 0.0;
+    for (i = 0; i < PHYSICSLFO_TABLE_RETIRED; i++) {
+        if (!x->table_retired[i]) continue;
+        if (!running || reads - x->table_retired_at[i] >= 2) {
+            physics_table_release(x->table_retired[i]);
+            x->table_retired[i] = NULL;
+        } else {
+            retiring = 1;
+        }
     }
     
-    // Combine equilibrium approach with decaying wobble
-    double result = base_level + (beating * wobble_amplitude);
+    if (x->table_pending && (!x->table_want || PHYSICSLFO_LOAD_ACQUIRE(&x->table_want->ready))) {
+        t_physics_table *old = x->table;
+        long slot = 0;
+        
+        // With every retire slot taken the swap waits for the next poll
+        while (slot < PHYSICSLFO_TABLE_RETIRED && x->table_retired[slot]) slot++;
+        if (!old || !running || slot < PHYSICSLFO_TABLE_RETIRED) {
+            PHYSICSLFO_STORE_RELEASE_PTR(&x->table, x->table_want);
+            x->table_want = NULL;
+            x->table_pending = 0;
+            if (old && running) {
+                x->table_retired[slot] = old;
+                x->table_retired_at[slot] = PHYSICSLFO_LOAD_ACQUIRE(&x->sync_reads);
+                retiring = 1;
+            } else {
+                physics_table_release(old);
+            }
+        }
+    }
+    return retiring || x->table_pending;
+}
+
+void physicslfo_table_tick(t_physicslfo *x) {
+    critical_enter(x->message_lock);
+    if (physicslfo_table_service(x)) {
+        clock_delay(x->table_clock, PHYSICSLFO_TABLE_POLL);
+    }
+    critical_exit(x->message_lock);
+}
+
+// Ask for the table of the current float parameters (or for none when
+// @quality is exact). Called from the message thread whenever type, physics,
+// damping, @quality or @tablesize change. Rendering happens on the worker:
+// perform keeps playing the previous table until the new one is ready, then
+// the pointer is swapped and the old table released after perform's next block.
+void physicslfo_table_update(t_physicslfo *x) {
+    long type = (long)x->type_float;
+    long param_step = (long)(CLAMP(x->physics_float, 0.0, 1.0) * PHYSICSLFO_TABLE_QUANT + 0.5);
+    long damping_step = (long)(CLAMP(x->damping_float, 0.0, 1.0) * PHYSICSLFO_TABLE_QUANT + 0.5);
+    long none = !x->quality_table || type >= PHYSICS_BUILTIN_TYPES ||     // Plugins have no tables
+                x->jitter[0] > 0.0 || x->jitter[1] > 0.0 || x->jitter[2] > 0.0;
     
-    return result;
-}
\ No newline at end of file
+    critical_enter(x->message_lock);
+    if (none ? !x->table : physics_table_matches(x->table, type, param_step, damping_step, x->table_size)) {
+        // Back to what is already playing
+        physics_table_release(x->table_want);
+        x->table_want = NULL;
+        x->table_pending = 0;
+    } else if (!x->table_pending || (none ? x->table_want != NULL :
+               !physics_table_matches(x->table_want, type, param_step, damping_step, x->table_size))) {
+        physics_table_release(x->table_want);
+        x->table_want = none ? NULL : physics_table_acquire(type, param_step, damping_step, x->table_size);
+        x->table_pending = 1;
+    }
+    if (physicslfo_table_service(x)) {
+        clock_delay(x->table_clock, PHYSICSLFO_TABLE_POLL);
+    }
+    critical_exit(x->message_lock);
+}